@@ -0,0 +1,36 @@
+#ifndef SCH_BENCH_H
+#define SCH_BENCH_H
+
+// Shared helpers for the programs in bench/. Build and run them all with "make bench".
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+/// Seconds on a monotonic clock.
+static inline double bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/// Written with results so the compiler cannot drop the work that produced them.
+static volatile uint64_t bench_sink;
+
+/// A small deterministic generator (xorshift64*), so every run sees the same inputs.
+static inline uint64_t bench_rand(uint64_t *state)
+{
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * UINT64_C(2685821657736338717);
+}
+
+/// Bytes per second as GB/s.
+static inline double bench_gbps(double bytes, double seconds)
+{
+    return bytes / seconds / 1e9;
+}
+
+#endif // SCH_BENCH_H
@@ -0,0 +1,105 @@
+// sch_dar storage: scan throughput and growth cost, with and without huge pages.
+
+#include <string.h>
+#include "sch_array.h"
+#include "bench.h"
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    uint32_t *data;
+} u32_array;
+
+#define SCAN_BYTES ((size_t)256 << 20)
+#define SCAN_PASSES 5
+
+/// Bytes of transparent huge pages currently mapped by this process, or -1 if unknown.
+static long anon_huge_kb(void)
+{
+    char line[256];
+    long kb = -1;
+    FILE *f = fopen("/proc/self/smaps_rollup", "r");
+    if (f == NULL)
+    {
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        if (sscanf(line, "AnonHugePages: %ld kB", &kb) == 1)
+        {
+            break;
+        }
+    }
+    fclose(f);
+    return kb;
+}
+
+static void bench_scan(const char *name, size_t alignment, unsigned flags)
+{
+    u32_array arr;
+    size_t n = SCAN_BYTES / sizeof(uint32_t);
+    size_t i;
+    int pass;
+    double best = 1e30;
+
+    darnewx(&arr, n, alignment, flags);
+    for (i = 0; i < n; i++)
+    {
+        arr.data[i] = (uint32_t)i;
+    }
+    arr.size = n;
+
+    for (pass = 0; pass < SCAN_PASSES; pass++)
+    {
+        double t0 = bench_now();
+        uint64_t sum = 0;
+        for (i = 0; i < n; i++)
+        {
+            sum += arr.data[i];
+        }
+        double t = bench_now() - t0;
+        bench_sink += sum;
+        if (t < best)
+        {
+            best = t;
+        }
+    }
+
+    printf("  scan  %-26s %7.2f GB/s  (THP mapped: %ld kB)\n", name, bench_gbps((double)SCAN_BYTES, best), anon_huge_kb());
+    darfree(&arr);
+}
+
+/// Double the capacity of a full array from 1 MiB to 256 MiB, timing only the reallocations.
+static void bench_growth(const char *name, size_t alignment, unsigned flags)
+{
+    u32_array arr;
+    size_t capacity = ((size_t)1 << 20) / sizeof(uint32_t);
+    double total = 0.0;
+
+    darnewx(&arr, capacity, alignment, flags);
+    while (capacity * sizeof(uint32_t) < SCAN_BYTES)
+    {
+        double t0;
+        memset(arr.data, 1, capacity * sizeof(uint32_t));
+        arr.size = capacity;
+        capacity *= 2;
+        t0 = bench_now();
+        darres(&arr, capacity);
+        total += bench_now() - t0;
+    }
+
+    printf("  grow  %-26s %7.2f ms total for 8 doublings to 256 MiB\n", name, total * 1e3);
+    darfree(&arr);
+}
+
+int main(void)
+{
+    printf("sch_array (%d MiB of uint32_t)\n", (int)(SCAN_BYTES >> 20));
+    bench_scan("darnew (16-byte)", 16, 0);
+    bench_scan("darnewx 64-byte", 64, 0);
+    bench_scan("darnewx 64-byte, hugepages", 64, SCH_DAR_HUGEPAGES);
+    bench_growth("darnew (malloc/realloc)", 16, 0);
+    bench_growth("hugepages (mmap/mremap)", 64, SCH_DAR_HUGEPAGES);
+    return 0;
+}
@@ -0,0 +1,82 @@
+// dstrhash: bulk throughput and short-key latency, against the byte-at-a-time FNV-1a loop it replaces.
+
+#include <stdlib.h>
+#include <string.h>
+#include "sch_string.h"
+#include "bench.h"
+
+static uint64_t fnv1a(const char *data, size_t len)
+{
+    uint64_t h = UINT64_C(14695981039346656037);
+    size_t i;
+    for (i = 0; i < len; i++)
+    {
+        h ^= (unsigned char)data[i];
+        h *= UINT64_C(1099511628211);
+    }
+    return h;
+}
+
+typedef uint64_t (*hash_fn)(const char *, size_t);
+
+/// GB/s hashing the same buffer repeatedly.
+static double throughput(hash_fn fn, const char *buf, size_t len)
+{
+    size_t reps = ((size_t)1 << 30) / len;
+    size_t i;
+    uint64_t acc = 0;
+    double t0 = bench_now();
+    for (i = 0; i < reps; i++)
+    {
+        acc += fn(buf, len);
+    }
+    double t = bench_now() - t0;
+    bench_sink += acc;
+    return bench_gbps((double)reps * (double)len, t);
+}
+
+/// Nanoseconds per hash when each key depends on the previous hash, so calls cannot overlap.
+static double latency(hash_fn fn, const char *buf, size_t len)
+{
+    size_t reps = 20000000;
+    size_t i;
+    uint64_t h = 0;
+    double t0 = bench_now();
+    for (i = 0; i < reps; i++)
+    {
+        h = fn(buf + (h & 63), len);
+    }
+    double t = bench_now() - t0;
+    bench_sink += h;
+    return t / (double)reps * 1e9;
+}
+
+int main(void)
+{
+    static const size_t short_lens[] = {4, 8, 16, 32, 64};
+    static const size_t long_lens[] = {256, 4096, (size_t)1 << 20};
+    size_t buf_len = ((size_t)1 << 20) + 64;
+    char *buf = (char *)malloc(buf_len);
+    uint64_t seed = 1;
+    size_t i;
+
+    for (i = 0; i < buf_len; i++)
+    {
+        buf[i] = (char)bench_rand(&seed);
+    }
+
+    printf("dstrhash vs FNV-1a\n");
+    for (i = 0; i < sizeof(short_lens) / sizeof(short_lens[0]); i++)
+    {
+        printf("  latency %7zu B    dstrhash %6.2f ns   fnv1a %6.2f ns\n", short_lens[i],
+               latency(dstrhashn, buf, short_lens[i]), latency(fnv1a, buf, short_lens[i]));
+    }
+    for (i = 0; i < sizeof(long_lens) / sizeof(long_lens[0]); i++)
+    {
+        printf("  bulk    %7zu B    dstrhash %6.2f GB/s fnv1a %6.2f GB/s\n", long_lens[i],
+               throughput(dstrhashn, buf, long_lens[i]), throughput(fnv1a, buf, long_lens[i]));
+    }
+
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,211 @@
+// Timer queues from 1K to 10M pending timers: the 4-ary heap, the indexed heap with decrease-key,
+// and the sorted sch_dar + darins approach it replaces (small sizes only, since each insert is O(n)).
+
+#include <stdlib.h>
+#include "sch_pqueue.h"
+#include "bench.h"
+
+typedef struct
+{
+    uint64_t deadline;
+    uint32_t id;
+} timer;
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    timer *data;
+} timer_array;
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    timer *data;
+    struct sch_pq_index index;
+} timer_queue;
+
+#define OPS 1000000
+#define SORTED_MAX 100000
+#define HORIZON (UINT64_C(1) << 32)
+
+static int timer_cmp(const void *a, const void *b)
+{
+    const timer *ta = a, *tb = b;
+    return (ta->deadline > tb->deadline) - (ta->deadline < tb->deadline);
+}
+
+/// Nanoseconds per pop + re-arm, the steady state of a timer loop.
+static double bench_heap(size_t n)
+{
+    timer_array q;
+    uint64_t rng = 1;
+    size_t i;
+    double t0;
+    timer t;
+
+    darnew(&q, n);
+    for (i = 0; i < n; i++)
+    {
+        t.deadline = bench_rand(&rng) % HORIZON;
+        t.id = (uint32_t)i;
+        darpush(&q, t);
+    }
+    pqify(&q, timer_cmp);
+
+    t0 = bench_now();
+    for (i = 0; i < OPS; i++)
+    {
+        pqpop(&q, &t, timer_cmp);
+        t.deadline += bench_rand(&rng) % HORIZON;
+        pqpush(&q, t, timer_cmp);
+    }
+    t0 = bench_now() - t0;
+
+    bench_sink += pqtop(&q)->deadline;
+    darfree(&q);
+    return t0 * 1e9 / OPS;
+}
+
+/// Nanoseconds per pqpush alone, filling an empty queue to n.
+static double bench_fill(size_t n)
+{
+    timer_array q;
+    uint64_t rng = 2;
+    size_t i;
+    double t0;
+    timer t;
+
+    darnew(&q, n);
+    t0 = bench_now();
+    for (i = 0; i < n; i++)
+    {
+        t.deadline = bench_rand(&rng) % HORIZON;
+        t.id = (uint32_t)i;
+        pqpush(&q, t, timer_cmp);
+    }
+    t0 = bench_now() - t0;
+
+    bench_sink += pqtop(&q)->deadline;
+    darfree(&q);
+    return t0 * 1e9 / (double)n;
+}
+
+/// Nanoseconds per ipqupd that moves a random timer earlier (a reschedule), with an ipqpop + ipqpush
+/// every fourth operation so the queue keeps turning over.
+static double bench_indexed(size_t n)
+{
+    timer_queue q;
+    uint64_t rng = 3;
+    size_t i;
+    double t0;
+    timer t;
+
+    ipqnew(&q, n);
+    for (i = 0; i < n; i++)
+    {
+        t.deadline = HORIZON + bench_rand(&rng) % HORIZON;
+        t.id = (uint32_t)i;
+        ipqpush(&q, t, t.id, timer_cmp);
+    }
+
+    t0 = bench_now();
+    for (i = 0; i < OPS; i++)
+    {
+        if ((i & 3) == 3)
+        {
+            ipqpop(&q, &t, timer_cmp);
+            t.deadline += HORIZON;
+            ipqpush(&q, t, t.id, timer_cmp);
+        }
+        else
+        {
+            size_t id = (size_t)(bench_rand(&rng) % n);
+            t = q.data[ipqpos(&q, id)];
+            t.deadline -= t.deadline / 8;
+            ipqupd(&q, t, id, timer_cmp);
+        }
+    }
+    t0 = bench_now() - t0;
+
+    bench_sink += ipqtop(&q)->deadline;
+    ipqfree(&q);
+    return t0 * 1e9 / OPS;
+}
+
+/// The old approach: a sch_dar kept sorted latest-first, so the next timer is at the end.
+static double bench_sorted(size_t n)
+{
+    timer_array q;
+    uint64_t rng = 1;
+    size_t i, ops = n >= SORTED_MAX ? OPS / 100 : OPS / 10;
+    double t0;
+    timer t;
+
+    darnew(&q, n);
+    for (i = 0; i < n; i++)
+    {
+        t.deadline = bench_rand(&rng) % HORIZON;
+        t.id = (uint32_t)i;
+        darpush(&q, t);
+    }
+    qsort(q.data, q.size, sizeof(timer), timer_cmp);
+    for (i = 0; i < n / 2; i++)
+    {
+        t = q.data[i];
+        q.data[i] = q.data[n - 1 - i];
+        q.data[n - 1 - i] = t;
+    }
+
+    t0 = bench_now();
+    for (i = 0; i < ops; i++)
+    {
+        size_t lo = 0, hi;
+        t = q.data[q.size - 1];
+        darpop(&q);
+        t.deadline += bench_rand(&rng) % HORIZON;
+        hi = q.size;
+        while (lo < hi)
+        {
+            size_t mid = lo + (hi - lo) / 2;
+            if (q.data[mid].deadline > t.deadline)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        darins(&q, t, lo);
+    }
+    t0 = bench_now() - t0;
+
+    bench_sink += q.data[q.size - 1].deadline;
+    darfree(&q);
+    return t0 * 1e9 / (double)ops;
+}
+
+int main(void)
+{
+    static const size_t sizes[] = {1000, 10000, 100000, 1000000, 10000000};
+    size_t i;
+
+    printf("4-ary timer queue (16-byte timers, %d operations per size), ns/op\n", OPS);
+    printf("%10s %10s %10s %12s %14s\n", "pending", "push", "pop+push", "ipqupd mix", "sorted darins");
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        size_t n = sizes[i];
+        printf("%10zu %10.1f %10.1f %12.1f", n, bench_fill(n), bench_heap(n), bench_indexed(n));
+        if (n <= SORTED_MAX)
+        {
+            printf(" %14.1f\n", bench_sorted(n));
+        }
+        else
+        {
+            printf(" %14s\n", "-");
+        }
+    }
+    return 0;
+}
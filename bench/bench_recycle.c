@@ -0,0 +1,106 @@
+// Allocation churn on 1 to 8 threads: malloc/free against sch_recycle_alloc/sch_recycle_free.
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "sch_recycle.h"
+#include "bench.h"
+
+#define OPS_PER_THREAD 4000000
+#define LIVE 256
+#define PASSES 3
+
+typedef struct
+{
+    int recycle;
+    uint64_t seed;
+} churn_args;
+
+/// Keeps LIVE buffers of 16 B to 8 KiB alive, replacing a random one on each operation.
+static void *churn(void *arg)
+{
+    const churn_args *args = arg;
+    void *live[LIVE] = {0};
+    size_t sizes[LIVE] = {0};
+    uint64_t rng = args->seed;
+    size_t i;
+
+    for (i = 0; i < OPS_PER_THREAD; i++)
+    {
+        uint64_t r = bench_rand(&rng);
+        size_t slot = (size_t)(r % LIVE);
+        size_t size = (size_t)16 << ((r >> 16) % 9);
+        size += (size_t)((r >> 32) % size);
+
+        if (args->recycle)
+        {
+            sch_recycle_free(live[slot], sizes[slot]);
+            live[slot] = sch_recycle_alloc(size);
+        }
+        else
+        {
+            free(live[slot]);
+            live[slot] = malloc(size);
+        }
+        *(volatile char *)live[slot] = 1;
+        sizes[slot] = size;
+    }
+
+    for (i = 0; i < LIVE; i++)
+    {
+        if (args->recycle)
+        {
+            sch_recycle_free(live[i], sizes[i]);
+        }
+        else
+        {
+            free(live[i]);
+        }
+    }
+    return NULL;
+}
+
+/// Best-of millions of alloc+free pairs per second across all threads.
+static double run(int threads, int recycle)
+{
+    pthread_t ids[8];
+    churn_args args[8];
+    double best = 1e30;
+    int pass, t;
+
+    for (pass = 0; pass < PASSES; pass++)
+    {
+        double t0 = bench_now();
+        for (t = 0; t < threads; t++)
+        {
+            args[t].recycle = recycle;
+            args[t].seed = (uint64_t)t * 7919 + 1;
+            pthread_create(&ids[t], NULL, churn, &args[t]);
+        }
+        for (t = 0; t < threads; t++)
+        {
+            pthread_join(ids[t], NULL);
+        }
+        t0 = bench_now() - t0;
+        if (t0 < best)
+        {
+            best = t0;
+        }
+    }
+    return (double)OPS_PER_THREAD * threads / best / 1e6;
+}
+
+int main(void)
+{
+    static const int thread_counts[] = {1, 2, 4, 8};
+    size_t i;
+
+    printf("Churn, %d live buffers of 16 B to 8 KiB per thread, M alloc+free/s (total)\n", LIVE);
+    printf("%8s %10s %10s %8s\n", "threads", "malloc", "recycle", "speedup");
+    for (i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++)
+    {
+        double m = run(thread_counts[i], 0);
+        double r = run(thread_counts[i], 1);
+        printf("%8d %10.1f %10.1f %7.2fx\n", thread_counts[i], m, r, r / m);
+    }
+    return 0;
+}
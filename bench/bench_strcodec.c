@@ -0,0 +1,110 @@
+// Hex and base64 throughput per kernel, on 1 MiB blobs and on 32-byte digests.
+
+#include "sch_strcodec.h"
+#include "bench.h"
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    unsigned char *data;
+} byte_array;
+
+#define TOTAL_BYTES ((size_t)64 << 20)
+#define PASSES 5
+
+enum { HEX_ENCODE, HEX_DECODE, BASE64_ENCODE, BASE64_DECODE, OPS };
+
+static const char *op_names[OPS] = {"hex encode", "hex decode", "base64 encode", "base64 decode"};
+
+/// Best-of GB/s of binary data encoded or decoded, working through TOTAL_BYTES in chunks of len.
+static double run(int op, const unsigned char *bytes, size_t len)
+{
+    string_t text;
+    byte_array out;
+    size_t reps = TOTAL_BYTES / len, r;
+    double best = 1e30;
+    int pass;
+
+    dstrnew(&text, "");
+    darnew(&out, len);
+    if (op == HEX_DECODE)
+    {
+        dstrcathex(&text, bytes, len);
+    }
+    else if (op == BASE64_DECODE)
+    {
+        dstrcatbase64(&text, bytes, len);
+    }
+
+    for (pass = 0; pass < PASSES; pass++)
+    {
+        double t0 = bench_now();
+        for (r = 0; r < reps; r++)
+        {
+            switch (op)
+            {
+            case HEX_ENCODE:
+                dstrclr(&text);
+                dstrcathex(&text, bytes, len);
+                bench_sink += dstrlen(&text);
+                break;
+            case BASE64_ENCODE:
+                dstrclr(&text);
+                dstrcatbase64(&text, bytes, len);
+                bench_sink += dstrlen(&text);
+                break;
+            case HEX_DECODE:
+                darclr(&out);
+                bench_sink += (uint64_t)dstrdechex(&text, sch_to_dar(&out));
+                break;
+            default:
+                darclr(&out);
+                bench_sink += (uint64_t)dstrdecbase64(&text, sch_to_dar(&out));
+                break;
+            }
+        }
+        t0 = bench_now() - t0;
+        if (t0 < best)
+        {
+            best = t0;
+        }
+    }
+
+    darfree(&out);
+    dstrfree(&text);
+    return bench_gbps((double)(reps * len), best);
+}
+
+int main(void)
+{
+    static const char *isa_names[] = {"scalar", "ssse3", "avx2"};
+    static const size_t sizes[] = {(size_t)1 << 20, 32};
+    static unsigned char bytes[(size_t)1 << 20];
+    uint64_t rng = 5;
+    size_t i, s;
+    int op, isa;
+
+    for (i = 0; i < sizeof(bytes); i++)
+    {
+        bytes[i] = (unsigned char)bench_rand(&rng);
+    }
+
+    printf("Hex and base64, GB/s of binary data\n");
+    printf("%14s %8s %8s %8s %8s\n", "", "bytes", isa_names[0], isa_names[1], isa_names[2]);
+    for (op = 0; op < OPS; op++)
+    {
+        for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+        {
+            printf("%14s %8zu", op_names[op], sizes[s]);
+            for (isa = SCH_STRCODEC_SCALAR; isa <= SCH_STRCODEC_AVX2; isa++)
+            {
+                dstrcodecisa(isa);
+                printf(" %8.2f", run(op, bytes, sizes[s]));
+            }
+            printf("\n");
+        }
+    }
+    dstrcodecisa(SCH_STRCODEC_AVX2);
+    return 0;
+}
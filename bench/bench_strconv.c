@@ -0,0 +1,130 @@
+// dstrtoi64/dstrtof64 against strtoll/strtod, parsing comma-separated numeric columns.
+
+#include <stdlib.h>
+#include <string.h>
+#include "sch_strconv.h"
+#include "bench.h"
+
+#define FIELDS 1000000
+#define PASSES 5
+
+typedef void (*format_fn)(char *out, uint64_t r);
+
+static void format_id(char *out, uint64_t r)
+{
+    sprintf(out, "%llu", (unsigned long long)(r % 100000000000ull));
+}
+
+static void format_signed(char *out, uint64_t r)
+{
+    sprintf(out, "%lld", (long long)(int64_t)r);
+}
+
+static void format_price(char *out, uint64_t r)
+{
+    sprintf(out, "%llu.%02llu", (unsigned long long)(r % 100000), (unsigned long long)((r >> 20) % 100));
+}
+
+static void format_measure(char *out, uint64_t r)
+{
+    sprintf(out, "%.6f", (double)(r % 10000000) / 1000.0 - 5000.0);
+}
+
+static void format_double(char *out, uint64_t r)
+{
+    double d;
+    r = (r & ~(UINT64_C(0x7FF) << 52)) | ((UINT64_C(1023) + (r >> 40) % 80 - 40) << 52);
+    memcpy(&d, &r, sizeof(d));
+    sprintf(out, "%.17g", d);
+}
+
+static void build_column(string_t *doc, format_fn format)
+{
+    char field[64];
+    uint64_t seed = 7;
+    size_t i;
+
+    dstrnew(doc, NULL);
+    for (i = 0; i < FIELDS; i++)
+    {
+        format(field, bench_rand(&seed));
+        dstrcat(doc, field);
+        dstrcatc(doc, ',');
+    }
+}
+
+/// Best time over PASSES to parse every field of the column.
+static double run(const string_t *doc, int kind)
+{
+    double best = 1e30;
+    int pass;
+
+    for (pass = 0; pass < PASSES; pass++)
+    {
+        const char *data = dstrc(doc);
+        size_t size = dstrlen(doc);
+        size_t pos = 0;
+        uint64_t acc = 0;
+        double t0 = bench_now();
+
+        while (pos < size)
+        {
+            char *end;
+            int64_t i;
+            double d;
+            switch (kind)
+            {
+            case 0:
+                acc += (uint64_t)strtoll(data + pos, &end, 10);
+                pos = (size_t)(end - data) + 1;
+                break;
+            case 1:
+                pos += dstrtoi64r(doc, pos, (size_t)-1, &i) + 1;
+                acc += (uint64_t)i;
+                break;
+            case 2:
+                d = strtod(data + pos, &end);
+                acc += (uint64_t)(int64_t)d;
+                pos = (size_t)(end - data) + 1;
+                break;
+            default:
+                pos += dstrtof64r(doc, pos, (size_t)-1, &d) + 1;
+                acc += (uint64_t)(int64_t)d;
+                break;
+            }
+        }
+
+        double t = bench_now() - t0;
+        bench_sink += acc;
+        if (t < best)
+        {
+            best = t;
+        }
+    }
+    return best;
+}
+
+static void report(const char *name, format_fn format, int is_float)
+{
+    string_t doc;
+    double libc, ours;
+
+    build_column(&doc, format);
+    libc = run(&doc, is_float ? 2 : 0);
+    ours = run(&doc, is_float ? 3 : 1);
+    printf("  %-22s %-8s %6.1f ns/field %7.0f MB/s   %-9s %6.1f ns/field %7.0f MB/s   %.1fx\n", name,
+           is_float ? "strtod" : "strtoll", libc * 1e9 / FIELDS, (double)dstrlen(&doc) / libc / 1e6,
+           is_float ? "dstrtof64" : "dstrtoi64", ours * 1e9 / FIELDS, (double)dstrlen(&doc) / ours / 1e6, libc / ours);
+    dstrfree(&doc);
+}
+
+int main(void)
+{
+    printf("sch_strconv (%d fields per column)\n", FIELDS);
+    report("ids (up to 11 digits)", format_id, 0);
+    report("signed 64-bit", format_signed, 0);
+    report("prices (%.2f)", format_price, 1);
+    report("measures (%.6f)", format_measure, 1);
+    report("doubles (%.17g)", format_double, 1);
+    return 0;
+}
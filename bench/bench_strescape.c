@@ -0,0 +1,192 @@
+// JSON/CSV/URL escaping on clean and escape-heavy fields, against a byte-at-a-time dstrcatc escaper.
+
+#include <string.h>
+#include "sch_strescape.h"
+#include "bench.h"
+
+#define FIELDS 20000
+#define FIELD_LEN 96
+#define PASSES 5
+
+typedef void (*escape_fn)(string_t *out, const char *field);
+
+static const char hex_upper[] = "0123456789ABCDEF";
+
+static void simd_json(string_t *out, const char *field)
+{
+    dstrcpy(out, field);
+    dstrescapejson(out);
+}
+
+static void simd_csv(string_t *out, const char *field)
+{
+    dstrcpy(out, field);
+    dstrescapecsv(out);
+}
+
+static void simd_url(string_t *out, const char *field)
+{
+    dstrcpy(out, field);
+    dstrurlencode(out);
+}
+
+static void naive_json(string_t *out, const char *field)
+{
+    const unsigned char *p;
+    dstrclr(out);
+    for (p = (const unsigned char *)field; *p; p++)
+    {
+        if (*p == '"' || *p == '\\')
+        {
+            dstrcatc(out, '\\');
+            dstrcatc(out, (char)*p);
+        }
+        else if (*p < 0x20)
+        {
+            dstrcat(out, "\\u00");
+            dstrcatc(out, hex_upper[*p >> 4]);
+            dstrcatc(out, hex_upper[*p & 15]);
+        }
+        else
+        {
+            dstrcatc(out, (char)*p);
+        }
+    }
+}
+
+static void naive_csv(string_t *out, const char *field)
+{
+    const char *p;
+    dstrclr(out);
+    if (strpbrk(field, ",\"\r\n") == NULL)
+    {
+        for (p = field; *p; p++)
+        {
+            dstrcatc(out, *p);
+        }
+        return;
+    }
+    dstrcatc(out, '"');
+    for (p = field; *p; p++)
+    {
+        if (*p == '"')
+        {
+            dstrcatc(out, '"');
+        }
+        dstrcatc(out, *p);
+    }
+    dstrcatc(out, '"');
+}
+
+static void naive_url(string_t *out, const char *field)
+{
+    const unsigned char *p;
+    dstrclr(out);
+    for (p = (const unsigned char *)field; *p; p++)
+    {
+        if ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z') || (*p >= '0' && *p <= '9') ||
+            *p == '-' || *p == '.' || *p == '_' || *p == '~')
+        {
+            dstrcatc(out, (char)*p);
+        }
+        else
+        {
+            dstrcatc(out, '%');
+            dstrcatc(out, hex_upper[*p >> 4]);
+            dstrcatc(out, hex_upper[*p & 15]);
+        }
+    }
+}
+
+/// Fill fields with letters and digits, and replace about one byte in every special_every with a special one.
+static void make_fields(char (*fields)[FIELD_LEN + 1], const char *specials, unsigned special_every)
+{
+    static const char clean[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    uint64_t rng = 7;
+    size_t i, j;
+
+    for (i = 0; i < FIELDS; i++)
+    {
+        for (j = 0; j < FIELD_LEN; j++)
+        {
+            uint64_t r = bench_rand(&rng);
+            if (special_every != 0 && r % special_every == 0)
+            {
+                fields[i][j] = specials[(r >> 32) % strlen(specials)];
+            }
+            else
+            {
+                fields[i][j] = clean[(r >> 32) % (sizeof(clean) - 1)];
+            }
+        }
+        fields[i][FIELD_LEN] = '\0';
+    }
+}
+
+/// Best-of GB/s of input escaped.
+static double run(escape_fn fn, char (*fields)[FIELD_LEN + 1])
+{
+    string_t out;
+    double best = 1e30;
+    int pass;
+    size_t i;
+
+    dstrnew(&out, "");
+    for (pass = 0; pass < PASSES; pass++)
+    {
+        double t0 = bench_now();
+        for (i = 0; i < FIELDS; i++)
+        {
+            fn(&out, fields[i]);
+            bench_sink += dstrlen(&out);
+        }
+        t0 = bench_now() - t0;
+        if (t0 < best)
+        {
+            best = t0;
+        }
+    }
+    dstrfree(&out);
+    return bench_gbps((double)FIELDS * FIELD_LEN, best);
+}
+
+int main(void)
+{
+    static char fields[FIELDS][FIELD_LEN + 1];
+    static const struct
+    {
+        const char *name;
+        escape_fn simd;
+        escape_fn naive;
+        const char *specials;
+    } kinds[] = {
+        {"json", simd_json, naive_json, "\"\\\n\t"},
+        {"csv", simd_csv, naive_csv, "\",\n"},
+        {"url", simd_url, naive_url, " /?&=:"},
+    };
+    static const struct
+    {
+        const char *name;
+        unsigned special_every;
+    } mixes[] = {
+        {"clean", 0},
+        {"1 in 64", 64},
+        {"1 in 4", 4},
+    };
+    size_t k, m;
+
+    printf("Escaping %d fields of %d bytes, GB/s of input\n", FIELDS, FIELD_LEN);
+    printf("%6s %10s %10s %10s %8s\n", "format", "specials", "dstrcatc", "in place", "speedup");
+    for (k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++)
+    {
+        for (m = 0; m < sizeof(mixes) / sizeof(mixes[0]); m++)
+        {
+            double naive, simd;
+            make_fields(fields, kinds[k].specials, mixes[m].special_every);
+            naive = run(kinds[k].naive, fields);
+            simd = run(kinds[k].simd, fields);
+            printf("%6s %10s %10.2f %10.2f %7.1fx\n", kinds[k].name, mixes[m].name, naive, simd, simd / naive);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Smoke test for the C++ wrappers in sch.hpp. Build and run it with "make cxx".
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include "sch.hpp"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                   \
+    do                                                                                \
+    {                                                                                 \
+        if (!(cond))                                                                  \
+        {                                                                             \
+            failures++;                                                               \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        }                                                                             \
+    } while (0)
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    int *data;
+} int_array;
+
+static void test_array()
+{
+    sch::array<int> arr = {5, 3, 9, 1, 7};
+    std::sort(arr.begin(), arr.end());
+    CHECK(std::is_sorted(arr.begin(), arr.end()));
+    CHECK(arr.size() == 5 && arr.front() == 1 && arr.back() == 9);
+
+    // Moving steals the buffer and leaves the source empty.
+    const int *buffer = arr.data();
+    sch::array<int> moved = std::move(arr);
+    CHECK(moved.data() == buffer && moved.size() == 5);
+    CHECK(arr.data() == nullptr && arr.size() == 0 && arr.capacity() == 0);
+
+    sch::array<int> assigned = {42};
+    assigned = std::move(moved);
+    CHECK(assigned.data() == buffer && moved.data() == nullptr);
+
+    // A moved-from array is still usable.
+    arr.push_back(3);
+    CHECK(arr.size() == 1 && arr[0] == 3);
+
+    // clone is a deep copy.
+    sch::array<int> copy = assigned.clone();
+    CHECK(copy.data() != assigned.data());
+    CHECK(std::equal(copy.begin(), copy.end(), assigned.begin(), assigned.end()));
+    copy[0] = 100;
+    CHECK(assigned[0] == 1);
+
+    // adopt takes a C array over, release hands it back.
+    int_array c;
+    darnew(&c, 4);
+    for (int i = 0; i < 10; i++)
+    {
+        darpush(&c, i);
+    }
+    int *c_buffer = c.data;
+    sch::array<int> adopted = sch::array<int>::adopt(*sch_to_dar(&c));
+    CHECK(c.data == nullptr && c.size == 0);
+    CHECK(adopted.data() == c_buffer && adopted.size() == 10 && adopted[9] == 9);
+    adopted.push_back(10);
+
+    struct sch_dar released = adopted.release();
+    CHECK(adopted.data() == nullptr && adopted.size() == 0);
+    CHECK(released.size == 11 && static_cast<int *>(released.data)[10] == 10);
+    sch_darfree(&released);
+
+    sch::array<double> aligned(16, 64, 0);
+    CHECK(aligned.alignment() == 64);
+    for (int i = 0; i < 1000; i++)
+    {
+        aligned.push_back(i);
+    }
+    CHECK(reinterpret_cast<std::uintptr_t>(aligned.data()) % 64 == 0);
+}
+
+static void test_string()
+{
+    // Heap strings move by stealing the buffer, short ones by copying the struct.
+    sch::string heap("a string long enough to live on the heap");
+    const char *buffer = heap.data();
+    sch::string moved = std::move(heap);
+    CHECK(moved.data() == buffer);
+    CHECK(heap.empty() && heap.view() == "");
+    CHECK(moved == "a string long enough to live on the heap");
+
+    sch::string small("short");
+    sch::string small_moved = std::move(small);
+    CHECK(small_moved == "short" && small.empty());
+
+    sch::string assigned("old");
+    assigned = std::move(moved);
+    CHECK(assigned.data() == buffer && moved.empty());
+
+    // clone is a deep copy, and keeps embedded nulls.
+    sch::string with_null(std::string_view("a\0b", 3));
+    sch::string copy = with_null.clone();
+    CHECK(copy.size() == 3 && copy.view() == with_null.view());
+    CHECK(copy.data() != with_null.data());
+    sch::string heap_copy = assigned.clone();
+    CHECK(heap_copy.data() != assigned.data() && heap_copy == assigned);
+
+    // adopt and release round-trip through the C API.
+    string_t c;
+    dstrnew(&c, "from C, and long enough for the heap");
+    sch::string adopted = sch::string::adopt(c);
+    CHECK(dstrlen(&c) == 0);
+    adopted += "!";
+    dstrcat(adopted.c_str_t(), "?");
+    CHECK(adopted == "from C, and long enough for the heap!?");
+    string_t released = adopted.release();
+    CHECK(adopted.empty());
+    CHECK(dstrcmp(&released, "from C, and long enough for the heap!?") == 0);
+    dstrfree(&released);
+
+    // std::sort works on the characters in place.
+    sch::string letters("dcbahgfe");
+    std::sort(letters.begin(), letters.end());
+    CHECK(letters == "abcdefgh");
+
+    // std::hash agrees with dstrhash and makes sch::string usable as a key.
+    sch::string key("key");
+    CHECK(std::hash<sch::string>()(key) == static_cast<size_t>(dstrhashn("key", 3)));
+    const sch::string &const_key = key;
+    CHECK(key.hash() == const_key.hash());
+
+    std::unordered_map<sch::string, int> counts;
+    counts.emplace(sch::string("one"), 1);
+    counts.emplace(sch::string("two"), 2);
+    counts.emplace(sch::string("a longer key that lives on the heap"), 3);
+    CHECK(counts.size() == 3);
+    CHECK(counts.at(sch::string("two")) == 2);
+    CHECK(counts.at(sch::string("a longer key that lives on the heap")) == 3);
+    CHECK(counts.find(sch::string("three")) == counts.end());
+}
+
+int main()
+{
+    test_array();
+    test_string();
+
+    if (failures > 0)
+    {
+        std::printf("%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("All C++ checks passed\n");
+    return 0;
+}
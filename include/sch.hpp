@@ -0,0 +1,518 @@
+/*
+ * Purpose:         C++ wrappers that own sch_dar and string_t storage.
+ * Date created:    October 2026
+ * Written by:      sch contributors
+ * License:         CC0 (public domain)
+ * Dependencies:    <cstddef>, <cstdint>, <functional>, <initializer_list>, <iterator>, <string_view>,
+ *                  <type_traits>, <span> (C++20 only), "sch_array.h", "sch_string.h"
+*/
+
+/*
+ * Usage:
+ * Requires C++17. The implementation still comes from the C headers, so define SCH_IMPL and include
+ * "sch_array.h" and "sch_string.h" in *one* C or C++ file as usual.
+ *
+ * sch::array<T> and sch::string wrap the same structs the C API uses and free them when they go out of scope.
+ * They can be moved, which steals the buffer, but not copied. Use clone for an explicit deep copy.
+ * Iterators are plain pointers into the storage, so <algorithm> (including the parallel overloads)
+ * works on the data in place.
+ *
+ * For example:
+
+sch::array<int> arr;
+arr.push_back(15);
+arr.push_back(5);
+arr.push_back(10);
+std::sort(arr.begin(), arr.end());          // sorts the sch_dar storage in place
+
+sch::string str("hello");
+str += ", world";
+std::string_view view = str;                // no copy
+dstrcat(str.c_str_t(), "!");                // the C API still works on the wrapped struct
+
+sch::string taken = std::move(str);         // str is left empty, taken owns the buffer
+
+ * sch::array<T> stores its elements with memcpy, so T must be trivially copyable.
+ * Like std::string, a short sch::string keeps its characters inside the object itself,
+ * so moving it invalidates pointers into it.
+ *
+*/
+
+#ifndef SCH_HPP
+#define SCH_HPP
+
+// Includes ==================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+#if __cplusplus >= 202002L && defined(__has_include)
+# if __has_include(<span>)
+#  include <span>
+#  define SCH_HPP_SPAN
+# endif // __has_include(<span>)
+#endif // C++20
+
+#include "sch_array.h"
+#include "sch_string.h"
+
+namespace sch
+{
+
+// Array =====================================================
+
+/// An owning dynamic array over the sch_dar layout.
+template <typename T>
+class array
+{
+    static_assert(std::is_trivially_copyable<T>::value, "sch::array moves its elements with memcpy");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using iterator = T *;
+    using const_iterator = const T *;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    /// Creates an empty array. Nothing is allocated until the first element is added.
+    array() noexcept : dar_{0, 0, nullptr} {}
+
+    /// Creates an empty array with the given capacity.
+    /// @param capacity The initial capacity of the array.
+    explicit array(size_type capacity) : array()
+    {
+        reserve(capacity);
+    }
+
+    /// Creates an empty array with the given capacity, alignment and flags. (see darnewx)
+    /// @param capacity The initial capacity of the array.
+    /// @param alignment The alignment of the array's data in bytes. (must be a power of two)
+    /// @param flags 0, or SCH_DAR_HUGEPAGES to back large arrays with huge pages.
+    array(size_type capacity, size_type alignment, unsigned flags) : array()
+    {
+        sch_darnewx(c_dar(), capacity > 0 ? capacity : 1, sizeof(T), alignment, flags);
+    }
+
+    /// Creates an array holding a copy of the given elements.
+    array(std::initializer_list<T> init) : array()
+    {
+        append(init.begin(), init.size());
+    }
+
+    array(const array &) = delete;
+    array &operator=(const array &) = delete;
+
+    /// Takes over the other array's buffer, leaving it empty.
+    array(array &&other) noexcept : dar_(other.dar_)
+    {
+        other.dar_ = {0, 0, nullptr};
+    }
+
+    /// Frees this array's buffer and takes over the other array's, leaving it empty.
+    array &operator=(array &&other) noexcept
+    {
+        if (this != &other)
+        {
+            sch_darfree(c_dar());
+            dar_ = other.dar_;
+            other.dar_ = {0, 0, nullptr};
+        }
+        return *this;
+    }
+
+    ~array()
+    {
+        sch_darfree(c_dar());
+    }
+
+    /// Takes ownership of an array created with the C API, leaving the struct empty.
+    /// @param dar The array to adopt. (its elements must be of type T)
+    static array adopt(struct sch_dar &dar) noexcept
+    {
+        array result;
+        result.dar_ = {dar.size, dar.capacity, static_cast<T *>(dar.data)};
+        dar.size = 0;
+        dar.capacity = 0;
+        dar.data = nullptr;
+        return result;
+    }
+
+    /// Gives up ownership of the storage. Free the result with darfree.
+    struct sch_dar release() noexcept
+    {
+        struct sch_dar result = {dar_.size, dar_.capacity, dar_.data};
+        dar_ = {0, 0, nullptr};
+        return result;
+    }
+
+    /// Makes a deep copy of the array.
+    array clone() const
+    {
+        array result;
+        result.append(data(), size());
+        return result;
+    }
+
+    /// The wrapped struct, for use with the C API.
+    struct sch_dar *c_dar() noexcept { return sch_to_dar(&dar_); }
+    const struct sch_dar *c_dar() const noexcept { return sch_to_const_dar(&dar_); }
+
+    size_type size() const noexcept { return dar_.size; }
+    size_type capacity() const noexcept { return dar_.capacity; }
+    bool empty() const noexcept { return dar_.size == 0; }
+    size_type alignment() const { return sch_daralign(c_dar()); }
+
+    T *data() noexcept { return dar_.data; }
+    const T *data() const noexcept { return dar_.data; }
+
+    T &operator[](size_type index) noexcept { return dar_.data[index]; }
+    const T &operator[](size_type index) const noexcept { return dar_.data[index]; }
+    T &front() noexcept { return dar_.data[0]; }
+    const T &front() const noexcept { return dar_.data[0]; }
+    T &back() noexcept { return dar_.data[dar_.size - 1]; }
+    const T &back() const noexcept { return dar_.data[dar_.size - 1]; }
+
+    iterator begin() noexcept { return dar_.data; }
+    iterator end() noexcept { return dar_.data + dar_.size; }
+    const_iterator begin() const noexcept { return dar_.data; }
+    const_iterator end() const noexcept { return dar_.data + dar_.size; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+#ifdef SCH_HPP_SPAN
+    std::span<T> span() noexcept { return std::span<T>(dar_.data, dar_.size); }
+    std::span<const T> span() const noexcept { return std::span<const T>(dar_.data, dar_.size); }
+#endif // SCH_HPP_SPAN
+
+    /// Adds an element to the end of the array.
+    void push_back(const T &value)
+    {
+        if (dar_.size == dar_.capacity)
+        {
+            // darpush doubles the capacity, which an empty array does not have yet. Copy the value
+            // first in case it lives inside the array.
+            T copy = value;
+            reserve(dar_.capacity > 0 ? dar_.capacity * 2 : 1);
+            dar_.data[dar_.size++] = copy;
+            return;
+        }
+        dar_.data[dar_.size++] = value;
+    }
+
+    /// Removes the last element, if any.
+    void pop_back() noexcept
+    {
+        sch_darpop(c_dar(), sizeof(T));
+    }
+
+    /// Inserts an element before the given position.
+    /// @return An iterator to the inserted element.
+    iterator insert(const_iterator pos, const T &value)
+    {
+        size_type index = static_cast<size_type>(pos - begin());
+        T copy = value;
+        if (index == dar_.size)
+        {
+            push_back(copy);
+        }
+        else
+        {
+            sch_darins(c_dar(), &copy, index, sizeof(T));
+        }
+        return begin() + index;
+    }
+
+    /// Removes the element at the given position.
+    /// @return An iterator to the element that followed it.
+    iterator erase(const_iterator pos) noexcept
+    {
+        size_type index = static_cast<size_type>(pos - begin());
+        sch_darrem(c_dar(), index, sizeof(T));
+        return begin() + index;
+    }
+
+    /// Appends a copy of n elements.
+    void append(const T *src, size_type n)
+    {
+        if (n > 0)
+        {
+            sch_darcat(c_dar(), src, n, sizeof(T));
+        }
+    }
+
+    /// Makes room for at least the given number of elements.
+    void reserve(size_type capacity)
+    {
+        if (capacity > dar_.capacity)
+        {
+            sch_darres(c_dar(), capacity, sizeof(T));
+        }
+    }
+
+    /// Resizes the array, value-initializing any new elements.
+    void resize(size_type size)
+    {
+        resize(size, T());
+    }
+
+    /// Resizes the array, filling any new elements with the given value.
+    void resize(size_type size, const T &value)
+    {
+        if (size > dar_.size)
+        {
+            T copy = value;
+            reserve(size);
+            for (size_type i = dar_.size; i < size; i++)
+            {
+                dar_.data[i] = copy;
+            }
+        }
+        dar_.size = size;
+    }
+
+    /// Removes every element, keeping the capacity.
+    void clear() noexcept
+    {
+        sch_darclr(c_dar());
+    }
+
+    /// Shrinks the capacity to the size.
+    void shrink_to_fit()
+    {
+        if (dar_.data != nullptr && dar_.size < dar_.capacity)
+        {
+            sch_darfit(c_dar(), sizeof(T));
+        }
+    }
+
+private:
+    // Same members in the same order as struct sch_dar, like any array type used with the C macros.
+    struct
+    {
+        size_type size;
+        size_type capacity;
+        T *data;
+    } dar_;
+};
+
+// String ====================================================
+
+/// An owning dynamic string over string_t.
+class string
+{
+public:
+    using value_type = char;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = char &;
+    using const_reference = const char &;
+    using pointer = char *;
+    using const_pointer = const char *;
+    using iterator = char *;
+    using const_iterator = const char *;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    /// Creates an empty string.
+    string() noexcept
+    {
+        dstrnew(&str_, nullptr);
+    }
+
+    /// Creates a string holding a copy of a C string.
+    explicit string(const char *cstr)
+    {
+        dstrnew(&str_, cstr);
+    }
+
+    /// Creates a string holding a copy of the given characters, which may include null characters.
+    explicit string(std::string_view view)
+    {
+        dstrnew(&str_, nullptr);
+        dstrcatn(&str_, view.data(), view.size());
+    }
+
+    string(const string &) = delete;
+    string &operator=(const string &) = delete;
+
+    /// Takes over the other string's buffer, leaving it empty.
+    string(string &&other) noexcept : str_(other.str_)
+    {
+        dstrnew(&other.str_, nullptr);
+    }
+
+    /// Frees this string's buffer and takes over the other string's, leaving it empty.
+    string &operator=(string &&other) noexcept
+    {
+        if (this != &other)
+        {
+            dstrfree(&str_);
+            str_ = other.str_;
+            dstrnew(&other.str_, nullptr);
+        }
+        return *this;
+    }
+
+    ~string()
+    {
+        dstrfree(&str_);
+    }
+
+    /// Takes ownership of a string created with the C API, leaving the struct empty.
+    static string adopt(string_t &str) noexcept
+    {
+        string result;
+        result.str_ = str;
+        dstrnew(&str, nullptr);
+        return result;
+    }
+
+    /// Gives up ownership of the storage. Free the result with dstrfree.
+    string_t release() noexcept
+    {
+        string_t result = str_;
+        dstrnew(&str_, nullptr);
+        return result;
+    }
+
+    /// Makes a deep copy of the string.
+    string clone() const
+    {
+        return string(view());
+    }
+
+    /// The wrapped struct, for use with the C API.
+    string_t *c_str_t() noexcept { return &str_; }
+    const string_t *c_str_t() const noexcept { return &str_; }
+
+    size_type size() const noexcept { return dstrlen(&str_); }
+    size_type length() const noexcept { return dstrlen(&str_); }
+    size_type capacity() const noexcept { return dstrcap(&str_); }
+    bool empty() const noexcept { return dstrlen(&str_) == 0; }
+    const char *c_str() const noexcept { return dstrc(&str_); }
+    const char *data() const noexcept { return dstrc(&str_); }
+
+    /// A writable pointer to the characters. Clears the cached hash, since the caller may change them.
+    char *data() noexcept
+    {
+        str_.type &= ~SCH_DSTR_HASH_BIT;
+        return const_cast<char *>(dstrc(&str_));
+    }
+
+    char &operator[](size_type index) noexcept { return data()[index]; }
+    const char &operator[](size_type index) const noexcept { return data()[index]; }
+    char &front() noexcept { return data()[0]; }
+    const char &front() const noexcept { return data()[0]; }
+    char &back() noexcept { return data()[size() - 1]; }
+    const char &back() const noexcept { return data()[size() - 1]; }
+
+    iterator begin() noexcept { return data(); }
+    iterator end() noexcept { return data() + size(); }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + size(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    std::string_view view() const noexcept { return std::string_view(data(), size()); }
+    operator std::string_view() const noexcept { return view(); }
+
+#ifdef SCH_HPP_SPAN
+    std::span<char> span() noexcept { return std::span<char>(data(), size()); }
+    std::span<const char> span() const noexcept { return std::span<const char>(data(), size()); }
+#endif // SCH_HPP_SPAN
+
+    /// Appends a copy of the given characters. (must not point into this string)
+    string &append(std::string_view view)
+    {
+        dstrcatn(&str_, view.data(), view.size());
+        return *this;
+    }
+
+    string &operator+=(std::string_view view) { return append(view); }
+    string &operator+=(const char *cstr) { return append(std::string_view(cstr)); }
+
+    string &operator+=(char c)
+    {
+        dstrcatc(&str_, c);
+        return *this;
+    }
+
+    void push_back(char c) { dstrcatc(&str_, c); }
+
+    /// Removes every character.
+    void clear() noexcept
+    {
+        dstrclr(&str_);
+    }
+
+    /// Shrinks the storage to the size, moving short strings back into the object.
+    void shrink_to_fit()
+    {
+        dstrfit(&str_);
+    }
+
+    /// The string's hash. (see dstrhash)
+    std::uint64_t hash() const noexcept
+    {
+        return dstrhash(&str_);
+    }
+
+    /// The string's hash, reusing the cached one if the string has not changed since. (see dstrhashcached)
+    std::uint64_t hash() noexcept
+    {
+        return dstrhashcached(&str_);
+    }
+
+    friend bool operator==(const string &a, const string &b) noexcept { return a.view() == b.view(); }
+    friend bool operator!=(const string &a, const string &b) noexcept { return a.view() != b.view(); }
+    friend bool operator<(const string &a, const string &b) noexcept { return a.view() < b.view(); }
+    friend bool operator==(const string &a, std::string_view b) noexcept { return a.view() == b; }
+    friend bool operator!=(const string &a, std::string_view b) noexcept { return a.view() != b; }
+    friend bool operator==(std::string_view a, const string &b) noexcept { return a == b.view(); }
+    friend bool operator!=(std::string_view a, const string &b) noexcept { return a != b.view(); }
+
+private:
+    string_t str_;
+};
+
+} // namespace sch
+
+namespace std
+{
+
+/// Lets sch::string be used as a key in unordered containers.
+template <>
+struct hash<sch::string>
+{
+    size_t operator()(const sch::string &str) const noexcept
+    {
+        return static_cast<size_t>(str.hash());
+    }
+};
+
+} // namespace std
+
+#endif // SCH_HPP
@@ -3,12 +3,24 @@
  * Date created:    November 2023
  * Written by:      Scott DiGregorio
  * License:         CC0 (public domain)
- * Dependencies:    <stddef.h>, <stdlib.h>, <string.h>, <assert.h>
+ * Dependencies:    <stddef.h>, <stdlib.h>, <string.h>, <assert.h>, <sys/mman.h> (Linux only),
+ *                  "sch_recycle.h" (SCH_RECYCLE only)
+*/
+
+/*
+ * Breaking change (October 2026):
+ * Array storage now carries a hidden header (four size_t, 32 bytes on 64-bit targets) in front of the data pointer,
+ * so arr.data is no longer the start of a malloc block. Passing it to free or realloc, or to code
+ * that frees it, corrupts the heap. Release arrays with darfree only, and copy the elements out
+ * if another owner needs a plain malloc buffer.
 */
 
 /*
  * Usage:
  * Define SCH_IMPL before including this file in *one* C file to create the implementation.
+ * On Linux, SCH_DAR_HUGEPAGES only uses mmap if <sys/mman.h> declares MAP_ANONYMOUS in that file,
+ * e.g. because it defines _GNU_SOURCE before its first #include. Otherwise (or with SCH_DAR_NO_MMAP defined)
+ * arrays always live on the heap.
  *
  * To use the type-generic macros, define a struct with the following members:
  * - size_t size
@@ -41,6 +53,21 @@ darrem(&arr, 2);    // remove the element at index 2
 darfree(&arr);      // free the memory used by the array
 
  *
+ * Array storage carries a hidden header in front of the data pointer (see the breaking change above),
+ * so the data must only ever be released with darfree (never with free).
+ *
+ * Use darnewx to create an array whose data is aligned to a larger boundary (e.g. 64 bytes for AVX-512).
+ * The alignment is remembered by the array and survives growth.
+ * On Linux, passing SCH_DAR_HUGEPAGES backs the array with mmap once it reaches SCH_DAR_HUGEPAGE_THRESHOLD bytes,
+ * advises the kernel to use transparent huge pages, and grows it with mremap instead of copying.
+ *
+ * For example:
+
+darnewx(&arr, 1024, 64, SCH_DAR_HUGEPAGES); // 64-byte aligned, huge-page backed once large
+
+ * Define SCH_DAR_NO_MMAP before including this file to disable the mmap backend entirely.
+ * Define SCH_RECYCLE in the implementation file to take heap storage from the buffers in "sch_recycle.h".
+ *
 */
 
 #ifndef SCH_ARRAY_H
@@ -64,6 +91,27 @@ SCH_API_BEGIN // Begin extern "C" block
 
 #include <stddef.h> // for size_t
 
+// Constants =================================================
+
+/// The alignment used by darnew. Any alignment up to this one costs no extra memory.
+#ifndef SCH_DAR_DEFAULT_ALIGNMENT
+# define SCH_DAR_DEFAULT_ALIGNMENT (sizeof(void *) * 2)
+#endif // SCH_DAR_DEFAULT_ALIGNMENT
+
+/// Flag for darnewx: back the array with mmap and transparent huge pages once it is large enough.
+/// Ignored on platforms without mmap.
+#define SCH_DAR_HUGEPAGES 0x1u
+
+/// The storage size (in bytes) at which an array created with SCH_DAR_HUGEPAGES switches to mmap.
+#ifndef SCH_DAR_HUGEPAGE_THRESHOLD
+# define SCH_DAR_HUGEPAGE_THRESHOLD ((size_t)2 << 20)
+#endif // SCH_DAR_HUGEPAGE_THRESHOLD
+
+/// The huge page size that mmap-backed storage is rounded up to.
+#ifndef SCH_DAR_HUGEPAGE_SIZE
+# define SCH_DAR_HUGEPAGE_SIZE ((size_t)2 << 20)
+#endif // SCH_DAR_HUGEPAGE_SIZE
+
 // Types =====================================================
 
 /// This struct represents a generic dynamic array.
@@ -80,6 +128,7 @@ struct sch_dar
 // Functions =================================================
 
 void sch_darnew(struct sch_dar *arr, size_t capacity, size_t elem_size);
+void sch_darnewx(struct sch_dar *arr, size_t capacity, size_t elem_size, size_t alignment, unsigned flags);
 void sch_darfree(struct sch_dar *arr);
 void sch_darpush(struct sch_dar *arr, const void *elem, size_t elem_size);
 void sch_darpop(struct sch_dar *arr, size_t elem_size);
@@ -95,6 +144,7 @@ size_t sch_darsiz(const struct sch_dar *arr);
 size_t sch_darcap(const struct sch_dar *arr);
 void *sch_dardat(const struct sch_dar *arr);
 int sch_darempty(const struct sch_dar *arr);
+size_t sch_daralign(const struct sch_dar *arr);
 
 // Macros ====================================================
 // These macros are type-generic, but they require a struct with the following members:
@@ -120,6 +170,13 @@ int sch_darempty(const struct sch_dar *arr);
 /// @param capacity The initial capacity of the array.
 #define darnew(arr, capacity) sch_darnew(sch_to_dar(arr), capacity, sch_elem_size(arr))
 
+/// Create a new dynamic array with the given capacity, alignment and flags.
+/// @param arr A pointer to the dynamic array struct.
+/// @param capacity The initial capacity of the array.
+/// @param alignment The alignment of the array's data in bytes. (must be a power of two)
+/// @param flags 0, or SCH_DAR_HUGEPAGES to back large arrays with huge pages.
+#define darnewx(arr, capacity, alignment, flags) sch_darnewx(sch_to_dar(arr), capacity, sch_elem_size(arr), (alignment), (flags))
+
 /// Free the memory used by the dynamic array.
 /// @param arr A pointer to the dynamic array struct.
 #define darfree(arr) sch_darfree(sch_to_dar(arr))
@@ -196,37 +253,79 @@ int sch_darempty(const struct sch_dar *arr);
 /// @return 1 if the array is empty, 0 otherwise.
 #define darempty(arr) sch_darempty(sch_to_const_dar(arr))
 
+/// Get the alignment of the data of the dynamic array.
+/// @param arr A pointer to the dynamic array struct.
+/// @return The alignment of the array's data in bytes.
+#define daralign(arr) sch_daralign(sch_to_const_dar(arr))
+
 SCH_API_END // End extern "C" block
 
 #endif // SCH_ARRAY_H
 
-#ifdef SCH_IMPL
+#if defined(SCH_IMPL) && !defined(SCH_ARRAY_IMPL)
+#define SCH_ARRAY_IMPL // headers that build on this one may include it again
 
 // Implementation =============================================
 
+#if defined(__linux__) && !defined(SCH_DAR_NO_MMAP)
+# include <sys/mman.h>
+# ifdef MAP_ANONYMOUS // strict ISO C builds without _GNU_SOURCE don't get it, and keep arrays on the heap
+#  define SCH_DAR_MMAP
+# endif // MAP_ANONYMOUS
+#endif // __linux__
+
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
+#ifdef SCH_RECYCLE
+# include "sch_recycle.h"
+#endif // SCH_RECYCLE
+
+/// Hidden header stored immediately before the data pointer of every array.
+struct sch_dar_block
+{
+    size_t bytes;  // usable bytes after the header
+    size_t align;  // alignment of the data pointer
+    size_t offset; // distance from the start of the underlying allocation to the data pointer
+    size_t flags;  // SCH_DAR_* flags given to darnewx, plus SCH_DAR_MAPPED
+};
+
+#define SCH_DAR_MAPPED 0x100u // storage is an mmap region rather than a malloc block
+
 static void sch_realloc_if_needed(struct sch_dar *arr, size_t new_size, size_t elem_size);
 static void sch_grow_if_needed(struct sch_dar *arr, size_t elem_size);
+static void *sch_dar_alloc(size_t bytes, size_t align, size_t flags);
+static void *sch_dar_realloc(void *data, size_t bytes, size_t used);
+static void sch_dar_release(void *data);
 
 void sch_darnew(struct sch_dar *arr, size_t capacity, size_t elem_size)
+{
+    sch_darnewx(arr, capacity, elem_size, SCH_DAR_DEFAULT_ALIGNMENT, 0);
+}
+
+void sch_darnewx(struct sch_dar *arr, size_t capacity, size_t elem_size, size_t alignment, unsigned flags)
 {
     assert(arr != NULL);
     assert(capacity > 0);
     assert(elem_size > 0);
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    if (alignment < SCH_DAR_DEFAULT_ALIGNMENT)
+    {
+        alignment = SCH_DAR_DEFAULT_ALIGNMENT;
+    }
 
     arr->size = 0;
     arr->capacity = capacity;
-    arr->data = malloc(capacity * elem_size);
+    arr->data = sch_dar_alloc(capacity * elem_size, alignment, flags);
 }
 
 void sch_darfree(struct sch_dar *arr)
 {
     assert(arr != NULL);
 
-    free(arr->data);
+    sch_dar_release(arr->data);
     arr->data = NULL;
     arr->size = 0;
     arr->capacity = 0;
@@ -350,7 +449,7 @@ void sch_darfit(struct sch_dar *arr, size_t elem_size)
     assert(elem_size > 0);
 
     arr->capacity = arr->size;
-    arr->data = realloc(arr->data, arr->capacity * elem_size);
+    arr->data = sch_dar_realloc(arr->data, arr->capacity * elem_size, arr->size * elem_size);
 }
 
 size_t sch_darsiz(const struct sch_dar *arr)
@@ -381,6 +480,18 @@ int sch_darempty(const struct sch_dar *arr)
     return arr->size == 0;
 }
 
+size_t sch_daralign(const struct sch_dar *arr)
+{
+    assert(arr != NULL);
+
+    if (arr->data == NULL)
+    {
+        return SCH_DAR_DEFAULT_ALIGNMENT;
+    }
+
+    return ((const struct sch_dar_block *)arr->data - 1)->align;
+}
+
 static void sch_realloc_if_needed(struct sch_dar *arr, size_t new_size, size_t elem_size)
 {
     assert(arr != NULL);
@@ -389,7 +500,7 @@ static void sch_realloc_if_needed(struct sch_dar *arr, size_t new_size, size_t e
     if (arr->capacity < new_size)
     {
         arr->capacity = new_size;
-        arr->data = realloc(arr->data, arr->capacity * elem_size);
+        arr->data = sch_dar_realloc(arr->data, arr->capacity * elem_size, arr->size * elem_size);
     }
 }
 
@@ -401,8 +512,228 @@ static void sch_grow_if_needed(struct sch_dar *arr, size_t elem_size)
     if (arr->size == arr->capacity)
     {
         arr->capacity *= 2;
-        arr->data = realloc(arr->data, arr->capacity * elem_size);
+        arr->data = sch_dar_realloc(arr->data, arr->capacity * elem_size, arr->size * elem_size);
     }
 }
 
-#endif // SCH_IMPL
\ No newline at end of file
+inline static size_t sch_dar_align_up(size_t value, size_t align)
+{
+    return (value + align - 1) & ~(align - 1);
+}
+
+inline static size_t sch_dar_slack(size_t align)
+{
+    // malloc already guarantees SCH_DAR_DEFAULT_ALIGNMENT, anything beyond that needs room to shift into place.
+    return align > SCH_DAR_DEFAULT_ALIGNMENT ? align - 1 : 0;
+}
+
+inline static size_t sch_dar_data_offset(const char *base, size_t align)
+{
+    return sch_dar_align_up((size_t)base + sizeof(struct sch_dar_block), align) - (size_t)base;
+}
+
+inline static void *sch_dar_place(char *base, size_t offset, size_t bytes, size_t align, size_t flags)
+{
+    struct sch_dar_block *block = (struct sch_dar_block *)(base + offset) - 1;
+    block->bytes = bytes;
+    block->align = align;
+    block->offset = offset;
+    block->flags = flags;
+    return base + offset;
+}
+
+inline static size_t sch_dar_heap_size(size_t bytes, size_t align)
+{
+    return sizeof(struct sch_dar_block) + sch_dar_slack(align) + bytes;
+}
+
+// Heap storage goes through the size-class recycler when SCH_RECYCLE is defined, and straight to malloc otherwise.
+
+inline static char *sch_dar_heap_alloc(size_t size)
+{
+#ifdef SCH_RECYCLE
+    return (char *)sch_recycle_alloc(size);
+#else
+    return (char *)malloc(size);
+#endif // SCH_RECYCLE
+}
+
+inline static char *sch_dar_heap_realloc(char *base, size_t old_size, size_t new_size)
+{
+#ifdef SCH_RECYCLE
+    return (char *)sch_recycle_realloc(base, old_size, new_size);
+#else
+    (void)old_size;
+    return (char *)realloc(base, new_size);
+#endif // SCH_RECYCLE
+}
+
+inline static void sch_dar_heap_free(char *base, size_t size)
+{
+#ifdef SCH_RECYCLE
+    sch_recycle_free(base, size);
+#else
+    (void)size;
+    free(base);
+#endif // SCH_RECYCLE
+}
+
+#ifdef SCH_DAR_MMAP
+
+inline static size_t sch_dar_map_length(size_t bytes, size_t align)
+{
+    return sch_dar_align_up(sizeof(struct sch_dar_block) + sch_dar_slack(align) + bytes, SCH_DAR_HUGEPAGE_SIZE);
+}
+
+inline static int sch_dar_wants_map(size_t bytes, size_t flags)
+{
+    return (flags & SCH_DAR_HUGEPAGES) && bytes >= SCH_DAR_HUGEPAGE_THRESHOLD;
+}
+
+inline static void sch_dar_advise(void *base, size_t length)
+{
+# ifdef MADV_HUGEPAGE
+    madvise(base, length, MADV_HUGEPAGE);
+# else
+    (void)base;
+    (void)length;
+# endif // MADV_HUGEPAGE
+}
+
+static void *sch_dar_map(size_t bytes, size_t align, size_t flags)
+{
+    size_t length = sch_dar_map_length(bytes, align);
+    void *base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    sch_dar_advise(base, length);
+    return sch_dar_place((char *)base, sch_dar_data_offset((char *)base, align), bytes, align, flags | SCH_DAR_MAPPED);
+}
+
+#endif // SCH_DAR_MMAP
+
+static void *sch_dar_alloc(size_t bytes, size_t align, size_t flags)
+{
+    char *base;
+
+#ifdef SCH_DAR_MMAP
+    if (sch_dar_wants_map(bytes, flags))
+    {
+        void *data = sch_dar_map(bytes, align, flags);
+        if (data != NULL)
+        {
+            return data;
+        }
+    }
+#endif // SCH_DAR_MMAP
+
+    base = sch_dar_heap_alloc(sch_dar_heap_size(bytes, align));
+    if (base == NULL)
+    {
+        return NULL;
+    }
+    return sch_dar_place(base, sch_dar_data_offset(base, align), bytes, align, flags & ~(size_t)SCH_DAR_MAPPED);
+}
+
+static void *sch_dar_realloc(void *data, size_t bytes, size_t used)
+{
+    struct sch_dar_block block;
+    size_t offset;
+    char *base;
+
+    if (data == NULL)
+    {
+        return sch_dar_alloc(bytes, SCH_DAR_DEFAULT_ALIGNMENT, 0);
+    }
+
+    block = *((struct sch_dar_block *)data - 1);
+    if (used > bytes)
+    {
+        used = bytes;
+    }
+
+    base = (char *)data - block.offset;
+
+#ifdef SCH_DAR_MMAP
+    if (block.flags & SCH_DAR_MAPPED)
+    {
+        size_t old_length = sch_dar_map_length(block.bytes, block.align);
+        size_t new_length = sch_dar_map_length(bytes, block.align);
+        if (old_length != new_length)
+        {
+# ifdef MREMAP_MAYMOVE
+            void *moved = mremap(base, old_length, new_length, MREMAP_MAYMOVE);
+            if (moved == MAP_FAILED)
+            {
+                return NULL;
+            }
+            base = (char *)moved;
+            sch_dar_advise(base, new_length);
+# else
+            void *fresh = sch_dar_map(bytes, block.align, block.flags);
+            if (fresh != NULL)
+            {
+                memcpy(fresh, data, used);
+            }
+            munmap(base, old_length);
+            return fresh;
+# endif // MREMAP_MAYMOVE
+        }
+    }
+    else if (sch_dar_wants_map(bytes, block.flags))
+    {
+        void *fresh = sch_dar_map(bytes, block.align, block.flags);
+        if (fresh != NULL)
+        {
+            memcpy(fresh, data, used);
+            sch_dar_heap_free(base, sch_dar_heap_size(block.bytes, block.align));
+            return fresh;
+        }
+    }
+
+    if (!(block.flags & SCH_DAR_MAPPED))
+#endif // SCH_DAR_MMAP
+    {
+        base = sch_dar_heap_realloc(base, sch_dar_heap_size(block.bytes, block.align), sch_dar_heap_size(bytes, block.align));
+        if (base == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    // The new block may sit at a different offset modulo the alignment, shift the contents into place if so.
+    offset = sch_dar_data_offset(base, block.align);
+    if (offset != block.offset)
+    {
+        memmove(base + offset, base + block.offset, used);
+    }
+
+    return sch_dar_place(base, offset, bytes, block.align, block.flags);
+}
+
+static void sch_dar_release(void *data)
+{
+    const struct sch_dar_block *block;
+
+    if (data == NULL)
+    {
+        return;
+    }
+
+    block = (const struct sch_dar_block *)data - 1;
+
+#ifdef SCH_DAR_MMAP
+    if (block->flags & SCH_DAR_MAPPED)
+    {
+        munmap((char *)data - block->offset, sch_dar_map_length(block->bytes, block->align));
+        return;
+    }
+#endif // SCH_DAR_MMAP
+
+    sch_dar_heap_free((char *)data - block->offset, sch_dar_heap_size(block->bytes, block->align));
+}
+
+#endif // SCH_IMPL && !SCH_ARRAY_IMPL
\ No newline at end of file
@@ -0,0 +1,557 @@
+/*
+ * Purpose:         Single-header library for d-ary heap priority queues.
+ * Date created:    October 2026
+ * Written by:      sch contributors
+ * License:         CC0 (public domain)
+ * Dependencies:    <stddef.h>, <stdint.h>, <string.h>, <assert.h>, "sch_array.h"
+*/
+
+/*
+ * Usage:
+ * Define SCH_IMPL before including this file in *one* C file to create the implementation.
+ *
+ * A priority queue is a dynamic array (see sch_array.h) kept in d-ary heap order.
+ * The heap is 4-ary by default, which keeps each node's children on one cache line for small elements.
+ * To change it, define SCH_PQ_ARITY in the implementation file (before including this file with SCH_IMPL).
+ * Only the implementation reads it, so defining it anywhere else has no effect.
+ *
+ * The order is given by a comparator with the same contract as qsort's:
+ * it returns a negative number if a should come out of the queue before b.
+ *
+ * For example:
+
+static int timer_cmp(const void *a, const void *b)
+{
+    const timer *ta = a, *tb = b;
+    return (ta->deadline > tb->deadline) - (ta->deadline < tb->deadline);
+}
+
+timer_array timers;
+darnew(&timers, 64);
+
+pqpush(&timers, t, timer_cmp);     // push a timer
+timer *next = pqtop(&timers);      // peek at the earliest timer (NULL if empty)
+pqpop(&timers, &t, timer_cmp);     // pop the earliest timer into t
+pqify(&timers, timer_cmp);         // turn an arbitrary array into a heap in O(n)
+
+darfree(&timers);
+
+ * The indexed variant additionally tracks where each element is by a caller-chosen id (a small integer),
+ * so elements can be updated (e.g. decrease-key) or removed in O(log n).
+ * It requires a struct with the following members:
+ * - size_t size
+ * - size_t capacity
+ * - T* data
+ * - struct sch_pq_index index
+ *
+ * For example:
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    task* data;
+    struct sch_pq_index index;
+} task_queue;
+
+task_queue q;
+ipqnew(&q, 64);
+ipqpush(&q, t, t.id, task_cmp);    // push a task under its id
+t.deadline = sooner;
+ipqupd(&q, t, t.id, task_cmp);     // change its priority
+size_t id = ipqpop(&q, &t, task_cmp);
+ipqfree(&q);
+
+ *
+*/
+
+#ifndef SCH_PQUEUE_H
+#define SCH_PQUEUE_H
+
+// Definitions ===============================================
+
+#ifndef SCH_API_BEGIN
+# ifdef __cplusplus
+#  define SCH_API_BEGIN extern "C" {
+#  define SCH_API_END   }
+# else
+#  define SCH_API_BEGIN
+#  define SCH_API_END
+# endif // __cplusplus
+#endif // SCH_API_BEGIN
+
+// Includes ==================================================
+
+#include <stddef.h> // for size_t
+#include "sch_array.h"
+
+SCH_API_BEGIN // Begin extern "C" block
+
+#ifndef SCH_PQ_ARITY
+# define SCH_PQ_ARITY 4
+#endif // SCH_PQ_ARITY
+
+/// The position of an id that is not in an indexed priority queue.
+#define SCH_PQ_NONE ((size_t)-1)
+
+// Types =====================================================
+
+/// Compares two elements. Returns a negative number if a should be popped before b,
+/// a positive number if b should be popped before a, and 0 otherwise.
+typedef int (*sch_pq_cmp)(const void *a, const void *b);
+
+/// The bookkeeping that maps ids to heap positions in an indexed priority queue.
+struct sch_pq_index
+{
+    struct
+    {
+        size_t size;
+        size_t capacity;
+        size_t *data; // id -> position in the heap, or SCH_PQ_NONE
+    } pos;
+    struct
+    {
+        size_t size;
+        size_t capacity;
+        size_t *data; // position in the heap -> id
+    } ids;
+};
+
+/// This struct represents a generic indexed priority queue.
+/// It is used by the macros to implement the type-generic functions.
+/// Ensure that any specific queue type you use has the same members as this struct
+/// in the same order. (size, capacity, data, index)
+struct sch_ipq
+{
+    size_t size;
+    size_t capacity;
+    void *data;
+    struct sch_pq_index index;
+};
+
+// Functions =================================================
+
+void sch_pqpush(struct sch_dar *arr, const void *elem, size_t elem_size, sch_pq_cmp cmp);
+void sch_pqpop(struct sch_dar *arr, void *optional_out, size_t elem_size, sch_pq_cmp cmp);
+void sch_pqify(struct sch_dar *arr, size_t elem_size, sch_pq_cmp cmp);
+
+void sch_ipqnew(struct sch_ipq *q, size_t capacity, size_t elem_size);
+void sch_ipqfree(struct sch_ipq *q);
+void sch_ipqpush(struct sch_ipq *q, const void *elem, size_t id, size_t elem_size, sch_pq_cmp cmp);
+size_t sch_ipqpop(struct sch_ipq *q, void *optional_out, size_t elem_size, sch_pq_cmp cmp);
+void sch_ipqupd(struct sch_ipq *q, const void *elem, size_t id, size_t elem_size, sch_pq_cmp cmp);
+int sch_ipqrem(struct sch_ipq *q, size_t id, void *optional_out, size_t elem_size, sch_pq_cmp cmp);
+size_t sch_ipqpos(const struct sch_ipq *q, size_t id);
+void sch_ipqclr(struct sch_ipq *q);
+
+// Macros ====================================================
+
+#define sch_to_ipq(q) ((struct sch_ipq *)(q))
+#define sch_to_const_ipq(q) ((const struct sch_ipq *)(q))
+
+/// Push an element onto the priority queue.
+/// @param arr A pointer to the dynamic array struct holding the heap.
+/// @param elem The element to push. (must be an lvalue, which may be an element of the queue itself)
+/// @param cmp The comparator. (sch_pq_cmp)
+#define pqpush(arr, elem, cmp) sch_pqpush(sch_to_dar(arr), sch_to_const_void_ptr(&(elem)), sch_elem_size(arr), (cmp))
+
+/// Pop the first element off the priority queue. The queue must not be empty.
+/// @param arr A pointer to the dynamic array struct holding the heap.
+/// @param optional_out_ptr A pointer that receives the popped element, or NULL.
+/// @param cmp The comparator. (sch_pq_cmp)
+#define pqpop(arr, optional_out_ptr, cmp) sch_pqpop(sch_to_dar(arr), sch_to_void_ptr(optional_out_ptr), sch_elem_size(arr), (cmp))
+
+/// Get a pointer to the first element of the priority queue without removing it.
+/// @param arr A pointer to the dynamic array struct holding the heap.
+/// @return A pointer to the first element, or NULL if the queue is empty.
+#define pqtop(arr) ((arr)->size > 0 ? (arr)->data : NULL)
+
+/// Reorder an arbitrary dynamic array into a priority queue in O(n).
+/// @param arr A pointer to the dynamic array struct.
+/// @param cmp The comparator. (sch_pq_cmp)
+#define pqify(arr, cmp) sch_pqify(sch_to_dar(arr), sch_elem_size(arr), (cmp))
+
+/// Create a new indexed priority queue with the given capacity.
+/// @param q A pointer to the indexed priority queue struct.
+/// @param capacity The initial capacity of the queue.
+#define ipqnew(q, capacity) sch_ipqnew(sch_to_ipq(q), (capacity), sch_elem_size(q))
+
+/// Free the memory used by the indexed priority queue.
+/// @param q A pointer to the indexed priority queue struct.
+#define ipqfree(q) sch_ipqfree(sch_to_ipq(q))
+
+/// Push an element onto the indexed priority queue under the given id. The id must not already be in the queue.
+/// @param q A pointer to the indexed priority queue struct.
+/// @param elem The element to push. (must be an lvalue, which may be an element of the queue itself)
+/// @param id The id of the element. Ids index a table, so keep them small and dense.
+/// @param cmp The comparator. (sch_pq_cmp)
+#define ipqpush(q, elem, id, cmp) sch_ipqpush(sch_to_ipq(q), sch_to_const_void_ptr(&(elem)), (id), sch_elem_size(q), (cmp))
+
+/// Pop the first element off the indexed priority queue. The queue must not be empty.
+/// @param q A pointer to the indexed priority queue struct.
+/// @param optional_out_ptr A pointer that receives the popped element, or NULL.
+/// @param cmp The comparator. (sch_pq_cmp)
+/// @return The id of the popped element.
+#define ipqpop(q, optional_out_ptr, cmp) sch_ipqpop(sch_to_ipq(q), sch_to_void_ptr(optional_out_ptr), sch_elem_size(q), (cmp))
+
+/// Replace the element with the given id and restore heap order. Works for both decrease-key and increase-key.
+/// @param q A pointer to the indexed priority queue struct.
+/// @param elem The new value of the element. (must be an lvalue that is not stored in the queue itself)
+/// @param id The id of the element, which must be in the queue.
+/// @param cmp The comparator. (sch_pq_cmp)
+#define ipqupd(q, elem, id, cmp) sch_ipqupd(sch_to_ipq(q), sch_to_const_void_ptr(&(elem)), (id), sch_elem_size(q), (cmp))
+
+/// Remove the element with the given id.
+/// @param q A pointer to the indexed priority queue struct.
+/// @param id The id of the element.
+/// @param optional_out_ptr A pointer that receives the removed element, or NULL.
+/// @param cmp The comparator. (sch_pq_cmp)
+/// @return 1 if the element was removed, 0 if the id was not in the queue.
+#define ipqrem(q, id, optional_out_ptr, cmp) sch_ipqrem(sch_to_ipq(q), (id), sch_to_void_ptr(optional_out_ptr), sch_elem_size(q), (cmp))
+
+/// Get the heap position of the element with the given id.
+/// @param q A pointer to the indexed priority queue struct.
+/// @param id The id of the element.
+/// @return The index of the element in data, or SCH_PQ_NONE if the id is not in the queue.
+#define ipqpos(q, id) sch_ipqpos(sch_to_const_ipq(q), (id))
+
+/// Get a pointer to the first element of the indexed priority queue without removing it.
+/// @param q A pointer to the indexed priority queue struct.
+/// @return A pointer to the first element, or NULL if the queue is empty.
+#define ipqtop(q) pqtop(q)
+
+/// Remove every element from the indexed priority queue.
+/// @param q A pointer to the indexed priority queue struct.
+#define ipqclr(q) sch_ipqclr(sch_to_ipq(q))
+
+SCH_API_END // End extern "C" block
+
+#endif // SCH_PQUEUE_H
+
+#if defined(SCH_IMPL) && !defined(SCH_PQUEUE_IMPL)
+#define SCH_PQUEUE_IMPL
+
+// Implementation =============================================
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+inline static void *sch_pq_at(const struct sch_dar *arr, size_t i, size_t elem_size)
+{
+    return (char *)arr->data + i * elem_size;
+}
+
+/// Move the element at from into to, keeping the index (if any) in sync.
+inline static void sch_pq_move(struct sch_dar *arr, struct sch_pq_index *index, size_t to, size_t from, size_t elem_size)
+{
+    memcpy(sch_pq_at(arr, to, elem_size), sch_pq_at(arr, from, elem_size), elem_size);
+    if (index != NULL)
+    {
+        size_t id = index->ids.data[from];
+        index->ids.data[to] = id;
+        index->pos.data[id] = to;
+    }
+}
+
+inline static void sch_pq_place(struct sch_dar *arr, struct sch_pq_index *index, size_t hole, const void *elem, size_t id, size_t elem_size)
+{
+    memcpy(sch_pq_at(arr, hole, elem_size), elem, elem_size);
+    if (index != NULL)
+    {
+        index->ids.data[hole] = id;
+        index->pos.data[id] = hole;
+    }
+}
+
+// The sift functions move a hole rather than swapping, so each level costs one copy.
+// elem must not live inside [0, n) of the heap.
+
+static size_t sch_pq_sift_up(struct sch_dar *arr, struct sch_pq_index *index, size_t hole, const void *elem, size_t elem_size, sch_pq_cmp cmp)
+{
+    while (hole > 0)
+    {
+        size_t parent = (hole - 1) / SCH_PQ_ARITY;
+        if (cmp(elem, sch_pq_at(arr, parent, elem_size)) >= 0)
+        {
+            break;
+        }
+        sch_pq_move(arr, index, hole, parent, elem_size);
+        hole = parent;
+    }
+    return hole;
+}
+
+static size_t sch_pq_sift_down(struct sch_dar *arr, struct sch_pq_index *index, size_t hole, const void *elem, size_t n, size_t elem_size, sch_pq_cmp cmp)
+{
+    for (;;)
+    {
+        size_t first = hole * SCH_PQ_ARITY + 1;
+        size_t last = first + SCH_PQ_ARITY;
+        size_t best = first;
+        size_t child;
+
+        if (first >= n)
+        {
+            break;
+        }
+        if (last > n)
+        {
+            last = n;
+        }
+
+        for (child = first + 1; child < last; child++)
+        {
+            if (cmp(sch_pq_at(arr, child, elem_size), sch_pq_at(arr, best, elem_size)) < 0)
+            {
+                best = child;
+            }
+        }
+        if (cmp(sch_pq_at(arr, best, elem_size), elem) >= 0)
+        {
+            break;
+        }
+
+        sch_pq_move(arr, index, hole, best, elem_size);
+        hole = best;
+    }
+    return hole;
+}
+
+/// Grow the heap by one slot and return where to read the pushed element from while it is sifted up.
+/// elem may be one of the heap's own elements, which growing would move and sifting would overwrite,
+/// so such an element is copied to the slot past the new end first, where sifting never looks.
+static const void *sch_pq_append(struct sch_dar *arr, const void *elem, size_t elem_size)
+{
+    uintptr_t offset = (uintptr_t)elem - (uintptr_t)arr->data;
+    int inside = arr->data != NULL && offset < arr->size * elem_size;
+    size_t needed = arr->size + (inside ? 2 : 1);
+
+    if (needed > arr->capacity)
+    {
+        sch_darres(arr, needed > arr->capacity * 2 ? needed : arr->capacity * 2, elem_size);
+    }
+
+    arr->size++;
+    if (inside)
+    {
+        return memcpy(sch_pq_at(arr, arr->size, elem_size), (char *)arr->data + offset, elem_size);
+    }
+    return elem;
+}
+
+void sch_pqpush(struct sch_dar *arr, const void *elem, size_t elem_size, sch_pq_cmp cmp)
+{
+    size_t hole;
+
+    assert(arr != NULL);
+    assert(elem != NULL);
+    assert(elem_size > 0);
+    assert(cmp != NULL);
+
+    elem = sch_pq_append(arr, elem, elem_size);
+    hole = sch_pq_sift_up(arr, NULL, arr->size - 1, elem, elem_size, cmp);
+    sch_pq_place(arr, NULL, hole, elem, 0, elem_size);
+}
+
+void sch_pqpop(struct sch_dar *arr, void *optional_out, size_t elem_size, sch_pq_cmp cmp)
+{
+    size_t hole;
+    const void *last;
+
+    assert(arr != NULL);
+    assert(arr->size > 0);
+    assert(elem_size > 0);
+    assert(cmp != NULL);
+
+    if (optional_out != NULL)
+    {
+        memcpy(optional_out, arr->data, elem_size);
+    }
+
+    // The old last element sits just past the new end, where sifting never looks.
+    arr->size--;
+    if (arr->size > 0)
+    {
+        last = sch_pq_at(arr, arr->size, elem_size);
+        hole = sch_pq_sift_down(arr, NULL, 0, last, arr->size, elem_size, cmp);
+        sch_pq_place(arr, NULL, hole, last, 0, elem_size);
+    }
+}
+
+void sch_pqify(struct sch_dar *arr, size_t elem_size, sch_pq_cmp cmp)
+{
+    void *scratch;
+    size_t i;
+
+    assert(arr != NULL);
+    assert(elem_size > 0);
+    assert(cmp != NULL);
+
+    if (arr->size < 2)
+    {
+        return;
+    }
+
+    // Use the slot past the end as scratch space for the element being sifted.
+    sch_darres(arr, arr->size + 1, elem_size);
+    scratch = sch_pq_at(arr, arr->size, elem_size);
+
+    i = (arr->size - 2) / SCH_PQ_ARITY + 1;
+    while (i-- > 0)
+    {
+        size_t hole;
+        memcpy(scratch, sch_pq_at(arr, i, elem_size), elem_size);
+        hole = sch_pq_sift_down(arr, NULL, i, scratch, arr->size, elem_size, cmp);
+        sch_pq_place(arr, NULL, hole, scratch, 0, elem_size);
+    }
+}
+
+void sch_ipqnew(struct sch_ipq *q, size_t capacity, size_t elem_size)
+{
+    assert(q != NULL);
+    assert(capacity > 0);
+    assert(elem_size > 0);
+
+    sch_darnew(sch_to_dar(q), capacity, elem_size);
+    darnew(&q->index.pos, capacity);
+    darnew(&q->index.ids, capacity);
+}
+
+void sch_ipqfree(struct sch_ipq *q)
+{
+    assert(q != NULL);
+
+    sch_darfree(sch_to_dar(q));
+    darfree(&q->index.pos);
+    darfree(&q->index.ids);
+}
+
+void sch_ipqpush(struct sch_ipq *q, const void *elem, size_t id, size_t elem_size, sch_pq_cmp cmp)
+{
+    struct sch_dar *arr = sch_to_dar(q);
+    size_t none = SCH_PQ_NONE;
+    size_t hole;
+
+    assert(q != NULL);
+    assert(elem != NULL);
+    assert(id != SCH_PQ_NONE);
+    assert(elem_size > 0);
+    assert(cmp != NULL);
+    assert(sch_ipqpos(q, id) == SCH_PQ_NONE);
+
+    while (q->index.pos.size <= id)
+    {
+        darpush(&q->index.pos, none);
+    }
+
+    elem = sch_pq_append(arr, elem, elem_size);
+    darpush(&q->index.ids, id);
+    hole = sch_pq_sift_up(arr, &q->index, arr->size - 1, elem, elem_size, cmp);
+    sch_pq_place(arr, &q->index, hole, elem, id, elem_size);
+}
+
+size_t sch_ipqpop(struct sch_ipq *q, void *optional_out, size_t elem_size, sch_pq_cmp cmp)
+{
+    size_t id;
+
+    assert(q != NULL);
+    assert(q->size > 0);
+
+    id = q->index.ids.data[0];
+    sch_ipqrem(q, id, optional_out, elem_size, cmp);
+    return id;
+}
+
+void sch_ipqupd(struct sch_ipq *q, const void *elem, size_t id, size_t elem_size, sch_pq_cmp cmp)
+{
+    struct sch_dar *arr = sch_to_dar(q);
+    size_t pos;
+    size_t hole;
+
+    assert(q != NULL);
+    assert(elem != NULL);
+    assert(elem_size > 0);
+    assert(cmp != NULL);
+
+    pos = sch_ipqpos(q, id);
+    assert(pos != SCH_PQ_NONE);
+
+    hole = sch_pq_sift_up(arr, &q->index, pos, elem, elem_size, cmp);
+    if (hole == pos)
+    {
+        hole = sch_pq_sift_down(arr, &q->index, pos, elem, arr->size, elem_size, cmp);
+    }
+    sch_pq_place(arr, &q->index, hole, elem, id, elem_size);
+}
+
+int sch_ipqrem(struct sch_ipq *q, size_t id, void *optional_out, size_t elem_size, sch_pq_cmp cmp)
+{
+    struct sch_dar *arr = sch_to_dar(q);
+    size_t pos;
+    size_t last;
+
+    assert(q != NULL);
+    assert(elem_size > 0);
+    assert(cmp != NULL);
+
+    pos = sch_ipqpos(q, id);
+    if (pos == SCH_PQ_NONE)
+    {
+        return 0;
+    }
+
+    if (optional_out != NULL)
+    {
+        memcpy(optional_out, sch_pq_at(arr, pos, elem_size), elem_size);
+    }
+
+    q->index.pos.data[id] = SCH_PQ_NONE;
+    last = arr->size - 1;
+    arr->size--;
+    darpop(&q->index.ids);
+
+    // Refill the hole with the old last element, which may need to go either way.
+    if (pos != last)
+    {
+        const void *elem = sch_pq_at(arr, last, elem_size);
+        size_t last_id = q->index.ids.data[last];
+        size_t hole = sch_pq_sift_up(arr, &q->index, pos, elem, elem_size, cmp);
+        if (hole == pos)
+        {
+            hole = sch_pq_sift_down(arr, &q->index, pos, elem, arr->size, elem_size, cmp);
+        }
+        sch_pq_place(arr, &q->index, hole, elem, last_id, elem_size);
+    }
+
+    return 1;
+}
+
+size_t sch_ipqpos(const struct sch_ipq *q, size_t id)
+{
+    assert(q != NULL);
+
+    if (id >= q->index.pos.size)
+    {
+        return SCH_PQ_NONE;
+    }
+
+    return q->index.pos.data[id];
+}
+
+void sch_ipqclr(struct sch_ipq *q)
+{
+    size_t i;
+
+    assert(q != NULL);
+
+    for (i = 0; i < q->size; i++)
+    {
+        q->index.pos.data[q->index.ids.data[i]] = SCH_PQ_NONE;
+    }
+
+    sch_darclr(sch_to_dar(q));
+    darclr(&q->index.ids);
+}
+
+#endif // SCH_IMPL && !SCH_PQUEUE_IMPL
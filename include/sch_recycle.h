@@ -0,0 +1,372 @@
+/*
+ * Purpose:         Single-header library for thread-local recycling of heap buffers by size class.
+ * Date created:    October 2026
+ * Written by:      sch contributors
+ * License:         CC0 (public domain)
+ * Dependencies:    <stddef.h>, <stdlib.h>, <string.h>, <assert.h>, <pthread.h> (POSIX only)
+*/
+
+/*
+ * Usage:
+ * Define SCH_IMPL before including this file in *one* C file to create the implementation.
+ *
+ * The recycler keeps freed buffers in per-thread free lists, one per power-of-two size class,
+ * and hands them back out instead of calling malloc again. Requests are rounded up to their class,
+ * so a freed buffer fits any later request of the same class. Requests larger than the biggest
+ * class go straight to malloc and free.
+ *
+ * Define SCH_RECYCLE in the implementation file to make sch_dar and string_t heap storage
+ * (including the growth paths) allocate from and free to the recycler.
+ * Once warmed up, a thread that keeps creating and freeing buffers of similar sizes stops calling malloc.
+ *
+ * For example:
+
+sch_recycle_setcap(4096, 256);      // keep up to 256 free buffers of the 4 KiB class per thread
+
+... handle requests ...
+
+struct sch_recycle_stats stats;
+sch_recycle_stats(&stats);          // hits, misses and what is cached on this thread
+
+sch_recycle_trim();                 // give this thread's cached buffers back to free now
+
+ * On POSIX systems the buffers a thread has cached are freed when it exits, through a pthread key destructor,
+ * so link with -pthread. Elsewhere, or if SCH_RECYCLE_NO_PTHREAD is defined in the implementation file,
+ * nothing frees them automatically: call sch_recycle_trim before a thread exits or its cached buffers leak.
+ * (The main thread's cache is never freed at exit, as it lives until the process ends.)
+ * A buffer may be freed on a different thread than the one that allocated it.
+ *
+*/
+
+#ifndef SCH_RECYCLE_H
+#define SCH_RECYCLE_H
+
+// Definitions ===============================================
+
+#ifndef SCH_API_BEGIN
+# ifdef __cplusplus
+#  define SCH_API_BEGIN extern "C" {
+#  define SCH_API_END   }
+# else
+#  define SCH_API_BEGIN
+#  define SCH_API_END
+# endif // __cplusplus
+#endif // SCH_API_BEGIN
+
+// Includes ==================================================
+
+#include <stddef.h> // for size_t
+
+SCH_API_BEGIN // Begin extern "C" block
+
+// Constants =================================================
+
+/// The smallest size class is 2^SCH_RECYCLE_MIN_SHIFT bytes.
+#ifndef SCH_RECYCLE_MIN_SHIFT
+# define SCH_RECYCLE_MIN_SHIFT 4
+#endif // SCH_RECYCLE_MIN_SHIFT
+
+/// The largest size class is 2^SCH_RECYCLE_MAX_SHIFT bytes. Larger requests are not recycled.
+#ifndef SCH_RECYCLE_MAX_SHIFT
+# define SCH_RECYCLE_MAX_SHIFT 20
+#endif // SCH_RECYCLE_MAX_SHIFT
+
+/// The number of free buffers each thread keeps per size class unless changed with sch_recycle_setcap.
+#ifndef SCH_RECYCLE_DEFAULT_CAP
+# define SCH_RECYCLE_DEFAULT_CAP 64
+#endif // SCH_RECYCLE_DEFAULT_CAP
+
+#define SCH_RECYCLE_CLASSES (SCH_RECYCLE_MAX_SHIFT - SCH_RECYCLE_MIN_SHIFT + 1)
+
+// Types =====================================================
+
+/// Counters for the calling thread's recycler.
+struct sch_recycle_stats
+{
+    size_t hits;          // allocations served from a free list
+    size_t misses;        // allocations that had to call malloc
+    size_t recycled;      // frees kept in a free list
+    size_t released;      // frees passed on to free (class full, or too large)
+    size_t cached_blocks; // buffers currently held in free lists
+    size_t cached_bytes;  // bytes currently held in free lists
+};
+
+// Functions =================================================
+
+/// Allocates a buffer of at least the given size.
+/// @param bytes The size of the buffer.
+/// @return The buffer. Release it with sch_recycle_free, passing the same size.
+void *sch_recycle_alloc(size_t bytes);
+
+/// Resizes a buffer, keeping its contents up to the smaller of the two sizes.
+/// @param ptr The buffer, or NULL to allocate a new one.
+/// @param old_bytes The size ptr was allocated with. (ignored if ptr is NULL)
+/// @param new_bytes The new size.
+/// @return The resized buffer, which may be ptr itself if both sizes share a class.
+void *sch_recycle_realloc(void *ptr, size_t old_bytes, size_t new_bytes);
+
+/// Releases a buffer to the calling thread's free lists, or to free if its class is full.
+/// @param ptr The buffer. (can be NULL)
+/// @param bytes The size ptr was allocated with.
+void sch_recycle_free(void *ptr, size_t bytes);
+
+/// Returns the number of bytes actually available in a buffer allocated with the given size.
+/// @param bytes The requested size.
+/// @return The size of the class the request falls into, or bytes itself if it is not recycled.
+size_t sch_recycle_usable(size_t bytes);
+
+/// Sets how many free buffers each thread keeps for the class that the given size falls into.
+/// This is a global setting, so change it before other threads start using the recycler.
+/// @param bytes A size in the class to configure.
+/// @param cap The maximum number of free buffers to keep. (0 disables recycling for the class)
+void sch_recycle_setcap(size_t bytes, size_t cap);
+
+/// Frees every buffer cached by the calling thread.
+/// Threads that exit without calling this leak their cached buffers unless the pthread destructor is in use (see above).
+void sch_recycle_trim(void);
+
+/// Gets the calling thread's recycler counters.
+/// @param stats Receives the counters.
+void sch_recycle_stats(struct sch_recycle_stats *stats);
+
+SCH_API_END // End extern "C" block
+
+#endif // SCH_RECYCLE_H
+
+#if defined(SCH_IMPL) && !defined(SCH_RECYCLE_IMPL)
+#define SCH_RECYCLE_IMPL // headers that build on this one may include it again
+
+// Implementation =============================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#if defined(_MSC_VER)
+# define SCH_THREAD_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+# define SCH_THREAD_LOCAL _Thread_local
+#else
+# define SCH_THREAD_LOCAL __thread
+#endif // SCH_THREAD_LOCAL
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(SCH_RECYCLE_NO_PTHREAD)
+# include <pthread.h>
+# define SCH_RECYCLE_PTHREAD
+#endif // POSIX
+
+/// A free buffer links to the next one through its own first bytes.
+struct sch_recycle_node
+{
+    struct sch_recycle_node *next;
+};
+
+struct sch_recycle_cache
+{
+    struct sch_recycle_node *heads[SCH_RECYCLE_CLASSES];
+    size_t counts[SCH_RECYCLE_CLASSES];
+    struct sch_recycle_stats stats;
+    int registered; // the thread-exit destructor will free this cache
+};
+
+static SCH_THREAD_LOCAL struct sch_recycle_cache sch_recycle_tls;
+
+// Caps are stored offset by one so that the zero-initialized table means "use the default".
+static size_t sch_recycle_caps[SCH_RECYCLE_CLASSES];
+
+/// The class index for a size, or -1 if it is too large to recycle.
+inline static int sch_recycle_class(size_t bytes)
+{
+    int index = 0;
+    size_t size = (size_t)1 << SCH_RECYCLE_MIN_SHIFT;
+
+    while (size < bytes)
+    {
+        if (++index >= SCH_RECYCLE_CLASSES)
+        {
+            return -1;
+        }
+        size <<= 1;
+    }
+    return index;
+}
+
+inline static size_t sch_recycle_class_size(int index)
+{
+    return (size_t)1 << (SCH_RECYCLE_MIN_SHIFT + index);
+}
+
+inline static size_t sch_recycle_cap(int index)
+{
+    return sch_recycle_caps[index] == 0 ? SCH_RECYCLE_DEFAULT_CAP : sch_recycle_caps[index] - 1;
+}
+
+static void sch_recycle_trim_cache(struct sch_recycle_cache *cache)
+{
+    int index;
+
+    for (index = 0; index < SCH_RECYCLE_CLASSES; index++)
+    {
+        struct sch_recycle_node *node = cache->heads[index];
+        while (node != NULL)
+        {
+            struct sch_recycle_node *next = node->next;
+            free(node);
+            node = next;
+        }
+        cache->heads[index] = NULL;
+        cache->counts[index] = 0;
+    }
+
+    cache->stats.cached_blocks = 0;
+    cache->stats.cached_bytes = 0;
+}
+
+#ifdef SCH_RECYCLE_PTHREAD
+
+// The key's value is the thread's cache, so its destructor runs when a thread that cached buffers exits.
+// If a later destructor frees more buffers into the cache, it registers again, and pthreads runs this
+// once more (for up to PTHREAD_DESTRUCTOR_ITERATIONS rounds).
+static pthread_key_t sch_recycle_key;
+static pthread_once_t sch_recycle_key_once = PTHREAD_ONCE_INIT;
+
+static void sch_recycle_thread_exit(void *cache)
+{
+    ((struct sch_recycle_cache *)cache)->registered = 0;
+    sch_recycle_trim_cache((struct sch_recycle_cache *)cache);
+}
+
+static void sch_recycle_make_key(void)
+{
+    pthread_key_create(&sch_recycle_key, sch_recycle_thread_exit);
+}
+
+#endif // SCH_RECYCLE_PTHREAD
+
+/// Called before a buffer is cached, so the thread's cache gets freed when it exits.
+inline static void sch_recycle_register(struct sch_recycle_cache *cache)
+{
+#ifdef SCH_RECYCLE_PTHREAD
+    if (!cache->registered)
+    {
+        cache->registered = 1;
+        pthread_once(&sch_recycle_key_once, sch_recycle_make_key);
+        pthread_setspecific(sch_recycle_key, cache);
+    }
+#else
+    (void)cache;
+#endif // SCH_RECYCLE_PTHREAD
+}
+
+void *sch_recycle_alloc(size_t bytes)
+{
+    struct sch_recycle_cache *cache = &sch_recycle_tls;
+    int index = sch_recycle_class(bytes);
+    struct sch_recycle_node *node;
+
+    if (index < 0)
+    {
+        cache->stats.misses++;
+        return malloc(bytes);
+    }
+
+    node = cache->heads[index];
+    if (node == NULL)
+    {
+        cache->stats.misses++;
+        return malloc(sch_recycle_class_size(index));
+    }
+
+    cache->heads[index] = node->next;
+    cache->counts[index]--;
+    cache->stats.hits++;
+    cache->stats.cached_blocks--;
+    cache->stats.cached_bytes -= sch_recycle_class_size(index);
+    return node;
+}
+
+void *sch_recycle_realloc(void *ptr, size_t old_bytes, size_t new_bytes)
+{
+    void *fresh;
+    int old_index, new_index;
+
+    if (ptr == NULL)
+    {
+        return sch_recycle_alloc(new_bytes);
+    }
+
+    old_index = sch_recycle_class(old_bytes);
+    new_index = sch_recycle_class(new_bytes);
+    if (old_index >= 0 && old_index == new_index)
+    {
+        return ptr;
+    }
+    if (old_index < 0 && new_index < 0)
+    {
+        return realloc(ptr, new_bytes);
+    }
+
+    fresh = sch_recycle_alloc(new_bytes);
+    memcpy(fresh, ptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+    sch_recycle_free(ptr, old_bytes);
+    return fresh;
+}
+
+void sch_recycle_free(void *ptr, size_t bytes)
+{
+    struct sch_recycle_cache *cache = &sch_recycle_tls;
+    struct sch_recycle_node *node;
+    int index;
+
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    index = sch_recycle_class(bytes);
+    if (index < 0 || cache->counts[index] >= sch_recycle_cap(index))
+    {
+        cache->stats.released++;
+        free(ptr);
+        return;
+    }
+
+    sch_recycle_register(cache);
+    node = (struct sch_recycle_node *)ptr;
+    node->next = cache->heads[index];
+    cache->heads[index] = node;
+    cache->counts[index]++;
+    cache->stats.recycled++;
+    cache->stats.cached_blocks++;
+    cache->stats.cached_bytes += sch_recycle_class_size(index);
+}
+
+size_t sch_recycle_usable(size_t bytes)
+{
+    int index = sch_recycle_class(bytes);
+    return index < 0 ? bytes : sch_recycle_class_size(index);
+}
+
+void sch_recycle_setcap(size_t bytes, size_t cap)
+{
+    int index = sch_recycle_class(bytes);
+
+    if (index >= 0)
+    {
+        sch_recycle_caps[index] = cap + 1;
+    }
+}
+
+void sch_recycle_trim(void)
+{
+    sch_recycle_trim_cache(&sch_recycle_tls);
+}
+
+void sch_recycle_stats(struct sch_recycle_stats *stats)
+{
+    assert(stats != NULL);
+
+    *stats = sch_recycle_tls.stats;
+}
+
+#endif // SCH_IMPL && !SCH_RECYCLE_IMPL
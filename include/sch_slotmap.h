@@ -0,0 +1,408 @@
+/*
+ * Purpose:         Single-header library for slot maps with stable, generational handles.
+ * Date created:    October 2026
+ * Written by:      sch contributors
+ * License:         CC0 (public domain)
+ * Dependencies:    <stddef.h>, <stdint.h>, <string.h>, <assert.h>, "sch_array.h"
+*/
+
+/*
+ * Usage:
+ * Define SCH_IMPL before including this file in *one* C file to create the implementation.
+ *
+ * A slot map stores its values densely packed in a dynamic array, so iterating over them is as fast
+ * as iterating over a plain sch_dar. Each value is identified by a handle that stays valid until
+ * that value is removed, no matter how many other values are inserted or removed in the meantime.
+ * Handles to removed values are detected and rejected. Insertion, removal and lookup are O(1).
+ *
+ * To use the type-generic macros, define a struct with the following members:
+ * - size_t size
+ * - size_t capacity
+ * - T* data
+ * - struct sch_slotmap_index index
+ * Where T is the type of the map's values.
+ *
+ * For example:
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    entity* data;
+    struct sch_slotmap_index index;
+} entity_map;
+
+ * Pass a pointer to instances of this struct to the macros.
+ *
+ * For example:
+
+entity_map map;
+slmnew(&map, 16);                         // create a new slot map with capacity 16
+
+sch_handle h = slmins(&map, player);      // insert a value and get its handle
+entity *e = (entity *)slmget(&map, h);    // look the value up (NULL if it was removed)
+slmrem(&map, h);                          // remove it, the last value moves into its place
+
+for (size_t i = 0; i < slmsiz(&map); i++) // iterate over the packed values
+{
+    update(&map.data[i], slmhdl(&map, i));
+}
+
+slmfree(&map);                            // free the memory used by the slot map
+
+ * Since removal moves the last value into the hole, pointers into data are invalidated by
+ * slmrem and slmins just like with a dynamic array. Only handles are stable.
+ *
+*/
+
+#ifndef SCH_SLOTMAP_H
+#define SCH_SLOTMAP_H
+
+// Definitions ===============================================
+
+#ifndef SCH_API_BEGIN
+# ifdef __cplusplus
+#  define SCH_API_BEGIN extern "C" {
+#  define SCH_API_END   }
+# else
+#  define SCH_API_BEGIN
+#  define SCH_API_END
+# endif // __cplusplus
+#endif // SCH_API_BEGIN
+
+// Includes ==================================================
+
+#include <stddef.h> // for size_t
+#include <stdint.h> // for uint32_t, uint64_t
+#include "sch_array.h"
+
+SCH_API_BEGIN // Begin extern "C" block
+
+// Types =====================================================
+
+/// A handle to a value in a slot map. The low 32 bits are the slot, the high 32 bits are its generation.
+/// Generations start at 1, so SCH_NULL_HANDLE (0) never refers to a value.
+typedef uint64_t sch_handle;
+
+#define SCH_NULL_HANDLE ((sch_handle)0)
+
+/// An entry of the indirection table.
+/// While the slot is in use, index is the position of its value in the packed data.
+/// While the slot is free, index is the next free slot.
+struct sch_slotmap_slot
+{
+    uint32_t index;
+    uint32_t generation;
+};
+
+/// The bookkeeping that maps handles to packed values.
+struct sch_slotmap_index
+{
+    struct
+    {
+        size_t size;
+        size_t capacity;
+        struct sch_slotmap_slot *data;
+    } slots;
+    struct
+    {
+        size_t size;
+        size_t capacity;
+        uint32_t *data; // the slot that owns each packed value
+    } owners;
+    uint32_t free_head;
+};
+
+/// This struct represents a generic slot map.
+/// It is used by the macros to implement the type-generic functions.
+/// Ensure that any specific slot map type you use has the same members as this struct
+/// in the same order. (size, capacity, data, index)
+/// The first three members make up a sch_dar holding the packed values.
+struct sch_slotmap
+{
+    size_t size;
+    size_t capacity;
+    void *data;
+    struct sch_slotmap_index index;
+};
+
+// Functions =================================================
+
+void sch_slmnew(struct sch_slotmap *map, size_t capacity, size_t elem_size);
+void sch_slmfree(struct sch_slotmap *map);
+sch_handle sch_slmins(struct sch_slotmap *map, const void *elem, size_t elem_size);
+int sch_slmrem(struct sch_slotmap *map, sch_handle handle, size_t elem_size);
+void *sch_slmget(const struct sch_slotmap *map, sch_handle handle, size_t elem_size);
+size_t sch_slmidx(const struct sch_slotmap *map, sch_handle handle);
+int sch_slmhas(const struct sch_slotmap *map, sch_handle handle);
+sch_handle sch_slmhdl(const struct sch_slotmap *map, size_t index);
+void sch_slmclr(struct sch_slotmap *map);
+
+// Macros ====================================================
+// These macros are type-generic, but they require a struct with the following members:
+// - size_t size
+// - size_t capacity
+// - T* data
+// - struct sch_slotmap_index index
+// Where T is the type of the map's values.
+
+#define sch_to_slotmap(map) ((struct sch_slotmap *)(map))
+#define sch_to_const_slotmap(map) ((const struct sch_slotmap *)(map))
+
+/// Create a new slot map with the given capacity.
+/// @param map A pointer to the slot map struct.
+/// @param capacity The initial capacity of the map.
+#define slmnew(map, capacity) sch_slmnew(sch_to_slotmap(map), (capacity), sch_elem_size(map))
+
+/// Free the memory used by the slot map.
+/// @param map A pointer to the slot map struct.
+#define slmfree(map) sch_slmfree(sch_to_slotmap(map))
+
+/// Insert a value into the slot map.
+/// @param map A pointer to the slot map struct.
+/// @param elem The value to insert. (must be an lvalue)
+/// @return The handle of the new value.
+#define slmins(map, elem) sch_slmins(sch_to_slotmap(map), sch_to_const_void_ptr(&(elem)), sch_elem_size(map))
+
+/// Remove the value with the given handle. The last packed value is moved into its place.
+/// @param map A pointer to the slot map struct.
+/// @param handle The handle of the value to remove.
+/// @return 1 if the value was removed, 0 if the handle was stale.
+#define slmrem(map, handle) sch_slmrem(sch_to_slotmap(map), (handle), sch_elem_size(map))
+
+/// Get a pointer to the value with the given handle.
+/// @param map A pointer to the slot map struct.
+/// @param handle The handle of the value.
+/// @return A pointer to the value, or NULL if the handle is stale.
+#define slmget(map, handle) sch_slmget(sch_to_const_slotmap(map), (handle), sch_elem_size(map))
+
+/// Get the position of the value with the given handle in the packed data.
+/// @param map A pointer to the slot map struct.
+/// @param handle The handle of the value.
+/// @return The index of the value in data, or (size_t)-1 if the handle is stale.
+#define slmidx(map, handle) sch_slmidx(sch_to_const_slotmap(map), (handle))
+
+/// Check whether the given handle refers to a value in the slot map.
+/// @param map A pointer to the slot map struct.
+/// @param handle The handle to check.
+/// @return 1 if the handle is valid, 0 otherwise.
+#define slmhas(map, handle) sch_slmhas(sch_to_const_slotmap(map), (handle))
+
+/// Get the handle of the value at the given position in the packed data.
+/// @param map A pointer to the slot map struct.
+/// @param index The index of the value in data.
+/// @return The handle of the value.
+#define slmhdl(map, index) sch_slmhdl(sch_to_const_slotmap(map), (index))
+
+/// Remove every value from the slot map. All handles become stale.
+/// @param map A pointer to the slot map struct.
+#define slmclr(map) sch_slmclr(sch_to_slotmap(map))
+
+/// Get the number of values in the slot map.
+/// @param map A pointer to the slot map struct.
+/// @return The number of values.
+#define slmsiz(map) ((map)->size)
+
+/// Get a pointer to the packed values of the slot map.
+/// @param map A pointer to the slot map struct.
+/// @return A pointer to the values.
+#define slmdat(map) ((map)->data)
+
+SCH_API_END // End extern "C" block
+
+#endif // SCH_SLOTMAP_H
+
+#if defined(SCH_IMPL) && !defined(SCH_SLOTMAP_IMPL)
+#define SCH_SLOTMAP_IMPL
+
+// Implementation =============================================
+
+#include <string.h>
+#include <assert.h>
+
+#define SCH_SLOTMAP_NO_FREE UINT32_MAX
+
+inline static sch_handle sch_slm_make_handle(uint32_t slot, uint32_t generation)
+{
+    return ((sch_handle)generation << 32) | slot;
+}
+
+inline static uint32_t sch_slm_handle_slot(sch_handle handle)
+{
+    return (uint32_t)handle;
+}
+
+inline static uint32_t sch_slm_handle_generation(sch_handle handle)
+{
+    return (uint32_t)(handle >> 32);
+}
+
+void sch_slmnew(struct sch_slotmap *map, size_t capacity, size_t elem_size)
+{
+    assert(map != NULL);
+    assert(capacity > 0 && capacity < SCH_SLOTMAP_NO_FREE);
+    assert(elem_size > 0);
+
+    sch_darnew(sch_to_dar(map), capacity, elem_size);
+    darnew(&map->index.slots, capacity);
+    darnew(&map->index.owners, capacity);
+    map->index.free_head = SCH_SLOTMAP_NO_FREE;
+}
+
+void sch_slmfree(struct sch_slotmap *map)
+{
+    assert(map != NULL);
+
+    sch_darfree(sch_to_dar(map));
+    darfree(&map->index.slots);
+    darfree(&map->index.owners);
+    map->index.free_head = SCH_SLOTMAP_NO_FREE;
+}
+
+sch_handle sch_slmins(struct sch_slotmap *map, const void *elem, size_t elem_size)
+{
+    struct sch_slotmap_slot *slot;
+    uint32_t slot_index;
+    uint32_t dense_index;
+
+    assert(map != NULL);
+    assert(elem != NULL);
+    assert(elem_size > 0);
+    assert(map->size < SCH_SLOTMAP_NO_FREE);
+
+    dense_index = (uint32_t)map->size;
+    if (map->index.free_head != SCH_SLOTMAP_NO_FREE)
+    {
+        slot_index = map->index.free_head;
+        slot = &map->index.slots.data[slot_index];
+        map->index.free_head = slot->index;
+    }
+    else
+    {
+        struct sch_slotmap_slot fresh;
+        fresh.index = 0;
+        fresh.generation = 1;
+        darpush(&map->index.slots, fresh);
+        slot_index = (uint32_t)(map->index.slots.size - 1);
+        slot = &map->index.slots.data[slot_index];
+    }
+
+    slot->index = dense_index;
+    sch_darpush(sch_to_dar(map), elem, elem_size);
+    darpush(&map->index.owners, slot_index);
+
+    return sch_slm_make_handle(slot_index, slot->generation);
+}
+
+int sch_slmrem(struct sch_slotmap *map, sch_handle handle, size_t elem_size)
+{
+    struct sch_slotmap_slot *slot;
+    uint32_t slot_index;
+    size_t dense_index;
+    size_t last;
+
+    assert(map != NULL);
+    assert(elem_size > 0);
+
+    dense_index = sch_slmidx(map, handle);
+    if (dense_index == (size_t)-1)
+    {
+        return 0;
+    }
+
+    // Keep the values packed by moving the last one into the hole and repointing its slot.
+    last = map->size - 1;
+    if (dense_index != last)
+    {
+        uint32_t moved_slot = map->index.owners.data[last];
+        memcpy((char *)map->data + dense_index * elem_size, (char *)map->data + last * elem_size, elem_size);
+        map->index.owners.data[dense_index] = moved_slot;
+        map->index.slots.data[moved_slot].index = (uint32_t)dense_index;
+    }
+    sch_darpop(sch_to_dar(map), elem_size);
+    darpop(&map->index.owners);
+
+    slot_index = sch_slm_handle_slot(handle);
+    slot = &map->index.slots.data[slot_index];
+    slot->generation = slot->generation + 1 != 0 ? slot->generation + 1 : 1;
+    slot->index = map->index.free_head;
+    map->index.free_head = slot_index;
+
+    return 1;
+}
+
+void *sch_slmget(const struct sch_slotmap *map, sch_handle handle, size_t elem_size)
+{
+    size_t dense_index;
+
+    assert(map != NULL);
+    assert(elem_size > 0);
+
+    dense_index = sch_slmidx(map, handle);
+    if (dense_index == (size_t)-1)
+    {
+        return NULL;
+    }
+
+    return (char *)map->data + dense_index * elem_size;
+}
+
+size_t sch_slmidx(const struct sch_slotmap *map, sch_handle handle)
+{
+    const struct sch_slotmap_slot *slot;
+    uint32_t slot_index;
+
+    assert(map != NULL);
+
+    slot_index = sch_slm_handle_slot(handle);
+    if (slot_index >= map->index.slots.size)
+    {
+        return (size_t)-1;
+    }
+
+    // Removing a value bumps its slot's generation, so a matching generation means the slot is live.
+    slot = &map->index.slots.data[slot_index];
+    if (slot->generation != sch_slm_handle_generation(handle))
+    {
+        return (size_t)-1;
+    }
+
+    return slot->index;
+}
+
+int sch_slmhas(const struct sch_slotmap *map, sch_handle handle)
+{
+    return sch_slmidx(map, handle) != (size_t)-1;
+}
+
+sch_handle sch_slmhdl(const struct sch_slotmap *map, size_t index)
+{
+    uint32_t slot_index;
+
+    assert(map != NULL);
+    assert(index < map->size);
+
+    slot_index = map->index.owners.data[index];
+    return sch_slm_make_handle(slot_index, map->index.slots.data[slot_index].generation);
+}
+
+void sch_slmclr(struct sch_slotmap *map)
+{
+    size_t i;
+
+    assert(map != NULL);
+
+    for (i = 0; i < map->size; i++)
+    {
+        uint32_t slot_index = map->index.owners.data[i];
+        struct sch_slotmap_slot *slot = &map->index.slots.data[slot_index];
+        slot->generation = slot->generation + 1 != 0 ? slot->generation + 1 : 1;
+        slot->index = map->index.free_head;
+        map->index.free_head = slot_index;
+    }
+
+    sch_darclr(sch_to_dar(map));
+    darclr(&map->index.owners);
+}
+
+#endif // SCH_IMPL && !SCH_SLOTMAP_IMPL
@@ -0,0 +1,664 @@
+/*
+ * Purpose:         Single-header library for hex and base64 encoding with dynamic strings.
+ * Date created:    October 2026
+ * Written by:      sch contributors
+ * License:         CC0 (public domain)
+ * Dependencies:    <stddef.h>, <stdint.h>, <assert.h>, <immintrin.h> (x86 only), "sch_string.h", "sch_array.h"
+*/
+
+/*
+ * Usage:
+ * Define SCH_IMPL before including this file in *one* C file to create the implementation.
+ *
+ * Encoders append text to a string_t, and decoders append bytes to a dynamic array of 1 byte elements
+ * (see sch_array.h). A decoder that fails leaves the array unchanged.
+ *
+ * For example:
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    unsigned char *data;
+} byte_array;
+
+string_t text;
+byte_array bytes;
+dstrnew(&text, "");
+darnew(&bytes, 16);
+
+dstrcatbase64(&text, "hello", 5);               // "aGVsbG8="
+if (!dstrdecbase64(&text, sch_to_dar(&bytes)))
+{
+    // not valid base64
+}
+
+darfree(&bytes);
+dstrfree(&text);
+
+ * On x86 the SSSE3 and AVX2 kernels are picked at runtime, so no compiler flags are needed.
+ * dstrcodecisa can rule kernels out, to test or benchmark the others.
+ *
+*/
+
+#ifndef SCH_STRCODEC_H
+#define SCH_STRCODEC_H
+
+// Definitions ===============================================
+
+#ifndef SCH_API_BEGIN
+# ifdef __cplusplus
+#  define SCH_API_BEGIN extern "C" {
+#  define SCH_API_END   }
+# else
+#  define SCH_API_BEGIN
+#  define SCH_API_END
+# endif // __cplusplus
+#endif // SCH_API_BEGIN
+
+// Includes ==================================================
+
+#include <stddef.h> // for size_t
+#include "sch_string.h"
+#include "sch_array.h"
+
+SCH_API_BEGIN // Begin extern "C" block
+
+/// Instruction sets for dstrcodecisa, from least to most capable.
+#define SCH_STRCODEC_SCALAR 0
+#define SCH_STRCODEC_SSSE3 1
+#define SCH_STRCODEC_AVX2 2
+
+// Functions =================================================
+
+/// Appends the lowercase hexadecimal encoding of a buffer to a string_t struct. The string grows at most once.
+/// @param str The string to append to.
+/// @param data The bytes to encode. (can be NULL if len is 0, and may point into str itself)
+/// @param len The number of bytes to encode.
+void dstrcathex(string_t *str, const void *data, size_t len);
+
+/// Appends the base64 encoding (RFC 4648, with padding) of a buffer to a string_t struct. The string grows at most once.
+/// @param str The string to append to.
+/// @param data The bytes to encode. (can be NULL if len is 0, and may point into str itself)
+/// @param len The number of bytes to encode.
+void dstrcatbase64(string_t *str, const void *data, size_t len);
+
+/// Decodes a hexadecimal string_t struct (either case) and appends the bytes to a dynamic array of 1 byte elements.
+/// @param str The string to decode.
+/// @param bytes The dynamic array to append to. (e.g. sch_to_dar(&byte_array))
+/// @return 1 on success, 0 if the string has an odd length or a non-hex character. (the array is left unchanged)
+int dstrdechex(const string_t *str, struct sch_dar *bytes);
+
+/// Decodes a base64 string_t struct (RFC 4648, padding optional) and appends the bytes to a dynamic array of 1 byte elements.
+/// @param str The string to decode.
+/// @param bytes The dynamic array to append to. (e.g. sch_to_dar(&byte_array))
+/// @return 1 on success, 0 if the string is not valid base64. (the array is left unchanged)
+int dstrdecbase64(const string_t *str, struct sch_dar *bytes);
+
+/// Limits the kernels the encoders and decoders may pick, e.g. to test or benchmark each one on a CPU that has them all.
+/// This is a process-wide setting: change it only while no other thread is encoding or decoding.
+/// @param isa The most capable instruction set to use. (SCH_STRCODEC_AVX2 by default; the CPU's own features still apply)
+void dstrcodecisa(int isa);
+
+SCH_API_END // End extern "C" block
+
+#endif // SCH_STRCODEC_H
+
+#if defined(SCH_IMPL) && !defined(SCH_STRCODEC_IMPL)
+#define SCH_STRCODEC_IMPL
+
+// Implementation =============================================
+// Hex and base64 have SSSE3 and AVX2 kernels on x86, chosen at runtime from the CPU's features,
+// and the scalar code handles whatever the kernels leave over (and everything elsewhere).
+// Output space is reserved once up front and written directly.
+
+#include <stdint.h>
+#include <assert.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+# include <immintrin.h>
+# define SCH_STRCODEC_X86_DISPATCH
+# define SCH_STRCODEC_TARGET(isa) __attribute__((target(isa)))
+#endif // x86
+
+static int sch_strcodec_max_isa = SCH_STRCODEC_AVX2;
+
+static const char sch_strcodec_hex_lower[] = "0123456789abcdef";
+static const char sch_strcodec_base64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Character to digit value, -1 for anything else. Tables rather than range checks keep the
+// scalar decoders free of branches that random input would mispredict.
+static const signed char sch_strcodec_hex_values[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+inline static int sch_strcodec_hex_value(char c)
+{
+    return sch_strcodec_hex_values[(unsigned char)c];
+}
+
+/// Make room for len more characters and return where they go. The caller sets the new length.
+/// The input may be part of the string itself, which growing would move, so *in is moved along with it.
+/// It is only ever read below the old length, and the output only goes past it, so the two never overlap.
+static char *sch_strcodec_reserve_tail(string_t *str, size_t len, const unsigned char **in)
+{
+    size_t size = dstrlen(str);
+    uintptr_t offset = (uintptr_t)*in - (uintptr_t)sch_dstr_data(str);
+
+    sch_dstr_invalidate_hash(str);
+    sch_dstr_grow_if_needed(str, size + len);
+    if (*in != NULL && offset < size)
+    {
+        *in = (const unsigned char *)sch_dstr_data(str) + offset;
+    }
+    return sch_dstr_data(str) + size;
+}
+
+/// Make room for len more bytes in a byte array and return where they go. The caller sets the new size.
+static unsigned char *sch_strcodec_reserve_bytes(struct sch_dar *bytes, size_t len)
+{
+    if (bytes->size + len > bytes->capacity)
+    {
+        sch_darres(bytes, bytes->size + len, 1);
+    }
+    return (unsigned char *)bytes->data + bytes->size;
+}
+
+// Character to base64 value, -1 for anything else (including the padding character).
+static const signed char sch_strcodec_base64_values[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+inline static int sch_strcodec_base64_value(unsigned char c)
+{
+    return sch_strcodec_base64_values[c];
+}
+
+#ifdef SCH_STRCODEC_X86_DISPATCH
+
+/// Whether the kernels for isa may run: the CPU has it and dstrcodecisa has not ruled it out.
+inline static int sch_strcodec_use(int isa)
+{
+    if (isa > sch_strcodec_max_isa)
+    {
+        return 0;
+    }
+    return isa == SCH_STRCODEC_AVX2 ? __builtin_cpu_supports("avx2") : __builtin_cpu_supports("ssse3");
+}
+
+// Hex -------------------------------------------------------
+
+SCH_STRCODEC_TARGET("ssse3")
+static size_t sch_strcodec_hex_encode_ssse3(char *out, const unsigned char *in, size_t len)
+{
+    const __m128i lut = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+
+    for (; len - i >= 16; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+        __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, nibble));
+        _mm_storeu_si128((__m128i *)(out + i * 2), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(out + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    return i;
+}
+
+SCH_STRCODEC_TARGET("avx2")
+static size_t sch_strcodec_hex_encode_avx2(char *out, const unsigned char *in, size_t len)
+{
+    const __m256i lut = _mm256_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+                                         '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+
+    for (; len - i >= 32; i += 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(in + i));
+        __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+        __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, nibble));
+        __m256i a = _mm256_unpacklo_epi8(hi, lo);
+        __m256i b = _mm256_unpackhi_epi8(hi, lo);
+        // unpack works within 128-bit lanes, so put the halves back in order.
+        _mm256_storeu_si256((__m256i *)(out + i * 2), _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256((__m256i *)(out + i * 2 + 32), _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    return i;
+}
+
+/// Convert 16 hex characters to their values, or report that one is invalid.
+SCH_STRCODEC_TARGET("ssse3")
+static int sch_strcodec_hex_values_ssse3(__m128i v, __m128i *values)
+{
+    __m128i digit = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+    __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i alpha = _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i is_alpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+    if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)) != 0xFFFF)
+    {
+        return 0;
+    }
+    *values = _mm_or_si128(_mm_and_si128(is_digit, digit), _mm_andnot_si128(is_digit, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+    return 1;
+}
+
+SCH_STRCODEC_TARGET("ssse3")
+static size_t sch_strcodec_hex_decode_ssse3(unsigned char *out, const char *in, size_t len, int *invalid)
+{
+    const __m128i weights = _mm_set1_epi16(0x0110); // high nibble * 16 + low nibble
+    size_t i = 0;
+
+    for (; len - i >= 32; i += 32)
+    {
+        __m128i a, b;
+        if (!sch_strcodec_hex_values_ssse3(_mm_loadu_si128((const __m128i *)(in + i)), &a) ||
+            !sch_strcodec_hex_values_ssse3(_mm_loadu_si128((const __m128i *)(in + i + 16)), &b))
+        {
+            *invalid = 1;
+            break;
+        }
+        _mm_storeu_si128((__m128i *)(out + i / 2), _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights)));
+    }
+    return i;
+}
+
+SCH_STRCODEC_TARGET("avx2")
+static int sch_strcodec_hex_values_avx2(__m256i v, __m256i *values)
+{
+    __m256i digit = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+    __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    __m256i alpha = _mm256_sub_epi8(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i is_alpha = _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, _mm256_set1_epi8(5)), alpha);
+    if ((uint32_t)_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_alpha)) != 0xFFFFFFFFu)
+    {
+        return 0;
+    }
+    *values = _mm256_or_si256(_mm256_and_si256(is_digit, digit), _mm256_andnot_si256(is_digit, _mm256_add_epi8(alpha, _mm256_set1_epi8(10))));
+    return 1;
+}
+
+SCH_STRCODEC_TARGET("avx2")
+static size_t sch_strcodec_hex_decode_avx2(unsigned char *out, const char *in, size_t len, int *invalid)
+{
+    const __m256i weights = _mm256_set1_epi16(0x0110);
+    size_t i = 0;
+
+    for (; len - i >= 64; i += 64)
+    {
+        __m256i a, b, packed;
+        if (!sch_strcodec_hex_values_avx2(_mm256_loadu_si256((const __m256i *)(in + i)), &a) ||
+            !sch_strcodec_hex_values_avx2(_mm256_loadu_si256((const __m256i *)(in + i + 32)), &b))
+        {
+            *invalid = 1;
+            break;
+        }
+        // packus works within 128-bit lanes, so put the quarters back in order.
+        packed = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+        _mm256_storeu_si256((__m256i *)(out + i / 2), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    return i;
+}
+
+// Base64 ----------------------------------------------------
+
+/// Turn the 6-bit indices in each byte into base64 characters:
+/// 'A' + index, adjusted past 25 (lowercase), past 51 (digits), and for 62 ('+') and 63 ('/').
+SCH_STRCODEC_TARGET("ssse3")
+static __m128i sch_strcodec_base64_chars_ssse3(__m128i indices)
+{
+    __m128i result = _mm_add_epi8(indices, _mm_set1_epi8('A'));
+    result = _mm_add_epi8(result, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(25)), _mm_set1_epi8(6)));
+    result = _mm_add_epi8(result, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(51)), _mm_set1_epi8(-75)));
+    result = _mm_add_epi8(result, _mm_and_si128(_mm_cmpeq_epi8(indices, _mm_set1_epi8(62)), _mm_set1_epi8(-15)));
+    result = _mm_add_epi8(result, _mm_and_si128(_mm_cmpeq_epi8(indices, _mm_set1_epi8(63)), _mm_set1_epi8(-12)));
+    return result;
+}
+
+SCH_STRCODEC_TARGET("ssse3")
+static size_t sch_strcodec_base64_encode_ssse3(char *out, const unsigned char *in, size_t len)
+{
+    size_t i = 0;
+
+    // Each block reads 16 bytes but only consumes 12.
+    for (; len - i >= 16; i += 12)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i indices;
+
+        // Spread each 3 byte group over 4 bytes, then move every 6-bit field to the bottom of its own byte.
+        v = _mm_shuffle_epi8(v, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        indices = _mm_or_si128(_mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040)),
+                               _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010)));
+        _mm_storeu_si128((__m128i *)(out + i / 3 * 4), sch_strcodec_base64_chars_ssse3(indices));
+    }
+    return i;
+}
+
+SCH_STRCODEC_TARGET("avx2")
+static size_t sch_strcodec_base64_encode_avx2(char *out, const unsigned char *in, size_t len)
+{
+    size_t i = 0;
+
+    // Two 12 byte blocks per iteration, one per 128-bit lane. The second load reads 4 bytes past its block.
+    for (; len - i >= 28; i += 24)
+    {
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(in + i))),
+                                            _mm_loadu_si128((const __m128i *)(in + i + 12)), 1);
+        __m256i indices, result;
+
+        v = _mm256_shuffle_epi8(v, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                                   10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        indices = _mm256_or_si256(_mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040)),
+                                  _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010)));
+
+        result = _mm256_add_epi8(indices, _mm256_set1_epi8('A'));
+        result = _mm256_add_epi8(result, _mm256_and_si256(_mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25)), _mm256_set1_epi8(6)));
+        result = _mm256_add_epi8(result, _mm256_and_si256(_mm256_cmpgt_epi8(indices, _mm256_set1_epi8(51)), _mm256_set1_epi8(-75)));
+        result = _mm256_add_epi8(result, _mm256_and_si256(_mm256_cmpeq_epi8(indices, _mm256_set1_epi8(62)), _mm256_set1_epi8(-15)));
+        result = _mm256_add_epi8(result, _mm256_and_si256(_mm256_cmpeq_epi8(indices, _mm256_set1_epi8(63)), _mm256_set1_epi8(-12)));
+        _mm256_storeu_si256((__m256i *)(out + i / 3 * 4), result);
+    }
+    return i;
+}
+
+/// Bytes of v that lie in [lo, hi], as a byte mask.
+SCH_STRCODEC_TARGET("ssse3")
+static __m128i sch_strcodec_in_range_ssse3(__m128i v, char lo, char hi)
+{
+    __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8((char)(hi - lo))), shifted);
+}
+
+SCH_STRCODEC_TARGET("ssse3")
+static size_t sch_strcodec_base64_decode_ssse3(unsigned char *out, size_t out_len, const char *in, size_t len, int *invalid)
+{
+    size_t i = 0;
+
+    // Each block writes 16 bytes but only produces 12.
+    for (; len - i >= 16 && out_len - i / 4 * 3 >= 16; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i upper = sch_strcodec_in_range_ssse3(v, 'A', 'Z');
+        __m128i lower = sch_strcodec_in_range_ssse3(v, 'a', 'z');
+        __m128i digit = sch_strcodec_in_range_ssse3(v, '0', '9');
+        __m128i plus = _mm_cmpeq_epi8(v, _mm_set1_epi8('+'));
+        __m128i slash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+        __m128i shift, merged;
+
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(plus, slash)))) != 0xFFFF)
+        {
+            *invalid = 1;
+            break;
+        }
+
+        shift = _mm_and_si128(upper, _mm_set1_epi8(-65));
+        shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(-71)));
+        shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(4)));
+        shift = _mm_or_si128(shift, _mm_and_si128(plus, _mm_set1_epi8(19)));
+        shift = _mm_or_si128(shift, _mm_and_si128(slash, _mm_set1_epi8(16)));
+
+        // Pack four 6-bit values into 24 bits, then gather the 3 bytes of every group.
+        merged = _mm_madd_epi16(_mm_maddubs_epi16(_mm_add_epi8(v, shift), _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+        merged = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storeu_si128((__m128i *)(out + i / 4 * 3), merged);
+    }
+    return i;
+}
+
+#endif // SCH_STRCODEC_X86_DISPATCH
+
+void dstrcathex(string_t *str, const void *data, size_t len)
+{
+    const unsigned char *in = (const unsigned char *)data;
+    size_t size, i = 0;
+    char *out;
+
+    assert(str);
+    assert(data || len == 0);
+
+    size = dstrlen(str);
+    out = sch_strcodec_reserve_tail(str, len * 2, &in);
+
+#ifdef SCH_STRCODEC_X86_DISPATCH
+    if (sch_strcodec_use(SCH_STRCODEC_AVX2))
+    {
+        i = sch_strcodec_hex_encode_avx2(out, in, len);
+    }
+    if (sch_strcodec_use(SCH_STRCODEC_SSSE3))
+    {
+        i += sch_strcodec_hex_encode_ssse3(out + i * 2, in + i, len - i);
+    }
+#endif // SCH_STRCODEC_X86_DISPATCH
+
+    for (; i < len; i++)
+    {
+        out[i * 2] = sch_strcodec_hex_lower[in[i] >> 4];
+        out[i * 2 + 1] = sch_strcodec_hex_lower[in[i] & 0xF];
+    }
+
+    sch_dstr_set_len(str, size + len * 2);
+}
+
+void dstrcatbase64(string_t *str, const void *data, size_t len)
+{
+    const unsigned char *in = (const unsigned char *)data;
+    size_t size, out_len, i = 0;
+    char *out;
+
+    assert(str);
+    assert(data || len == 0);
+
+    size = dstrlen(str);
+    out_len = (len + 2) / 3 * 4;
+    out = sch_strcodec_reserve_tail(str, out_len, &in);
+
+#ifdef SCH_STRCODEC_X86_DISPATCH
+    if (sch_strcodec_use(SCH_STRCODEC_AVX2))
+    {
+        i = sch_strcodec_base64_encode_avx2(out, in, len);
+    }
+    if (sch_strcodec_use(SCH_STRCODEC_SSSE3))
+    {
+        i += sch_strcodec_base64_encode_ssse3(out + i / 3 * 4, in + i, len - i);
+    }
+#endif // SCH_STRCODEC_X86_DISPATCH
+
+    for (; len - i >= 3; i += 3)
+    {
+        uint32_t group = ((uint32_t)in[i] << 16) | ((uint32_t)in[i + 1] << 8) | in[i + 2];
+        char *o = out + i / 3 * 4;
+        o[0] = sch_strcodec_base64_alphabet[group >> 18];
+        o[1] = sch_strcodec_base64_alphabet[(group >> 12) & 0x3F];
+        o[2] = sch_strcodec_base64_alphabet[(group >> 6) & 0x3F];
+        o[3] = sch_strcodec_base64_alphabet[group & 0x3F];
+    }
+    if (i < len)
+    {
+        uint32_t group = (uint32_t)in[i] << 16;
+        char *o = out + i / 3 * 4;
+        if (len - i == 2)
+        {
+            group |= (uint32_t)in[i + 1] << 8;
+        }
+        o[0] = sch_strcodec_base64_alphabet[group >> 18];
+        o[1] = sch_strcodec_base64_alphabet[(group >> 12) & 0x3F];
+        o[2] = len - i == 2 ? sch_strcodec_base64_alphabet[(group >> 6) & 0x3F] : '=';
+        o[3] = '=';
+    }
+
+    sch_dstr_set_len(str, size + out_len);
+}
+
+int dstrdechex(const string_t *str, struct sch_dar *bytes)
+{
+    const char *in;
+    unsigned char *out;
+    size_t len, i = 0;
+    int invalid = 0;
+
+    assert(str);
+    assert(bytes);
+
+    len = dstrlen(str);
+    if (len % 2 != 0)
+    {
+        return 0;
+    }
+    if (len == 0)
+    {
+        return 1;
+    }
+
+    in = dstrc(str);
+    out = sch_strcodec_reserve_bytes(bytes, len / 2);
+
+#ifdef SCH_STRCODEC_X86_DISPATCH
+    if (sch_strcodec_use(SCH_STRCODEC_AVX2))
+    {
+        i = sch_strcodec_hex_decode_avx2(out, in, len, &invalid);
+    }
+    if (!invalid && sch_strcodec_use(SCH_STRCODEC_SSSE3))
+    {
+        i += sch_strcodec_hex_decode_ssse3(out + i / 2, in + i, len - i, &invalid);
+    }
+    if (invalid)
+    {
+        return 0;
+    }
+#endif // SCH_STRCODEC_X86_DISPATCH
+
+    for (; i < len; i += 2)
+    {
+        int hi = sch_strcodec_hex_value(in[i]);
+        int lo = sch_strcodec_hex_value(in[i + 1]);
+        if ((hi | lo) < 0)
+        {
+            return 0;
+        }
+        out[i / 2] = (unsigned char)(hi * 16 + lo);
+    }
+
+    bytes->size += len / 2;
+    return 1;
+}
+
+int dstrdecbase64(const string_t *str, struct sch_dar *bytes)
+{
+    const char *in;
+    unsigned char *out;
+    size_t len, body, out_len, i = 0;
+    int invalid = 0;
+
+    assert(str);
+    assert(bytes);
+
+    len = dstrlen(str);
+    in = dstrc(str);
+
+    // Strip up to two padding characters, which may only complete the final quantum.
+    if (len % 4 == 0 && len > 0 && in[len - 1] == '=')
+    {
+        len -= in[len - 2] == '=' ? 2 : 1;
+    }
+    if (len % 4 == 1)
+    {
+        return 0;
+    }
+    if (len == 0)
+    {
+        return 1;
+    }
+
+    out_len = len / 4 * 3 + (len % 4 == 0 ? 0 : len % 4 - 1);
+    out = sch_strcodec_reserve_bytes(bytes, out_len);
+    body = len / 4 * 4;
+
+#ifdef SCH_STRCODEC_X86_DISPATCH
+    if (sch_strcodec_use(SCH_STRCODEC_SSSE3))
+    {
+        i = sch_strcodec_base64_decode_ssse3(out, out_len, in, body, &invalid);
+        if (invalid)
+        {
+            return 0;
+        }
+    }
+#endif // SCH_STRCODEC_X86_DISPATCH
+
+    for (; i < body; i += 4)
+    {
+        int a = sch_strcodec_base64_value((unsigned char)in[i]);
+        int b = sch_strcodec_base64_value((unsigned char)in[i + 1]);
+        int c = sch_strcodec_base64_value((unsigned char)in[i + 2]);
+        int d = sch_strcodec_base64_value((unsigned char)in[i + 3]);
+        uint32_t group;
+        if ((a | b | c | d) < 0)
+        {
+            return 0;
+        }
+        group = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6) | (uint32_t)d;
+        out[i / 4 * 3] = (unsigned char)(group >> 16);
+        out[i / 4 * 3 + 1] = (unsigned char)(group >> 8);
+        out[i / 4 * 3 + 2] = (unsigned char)group;
+    }
+    if (i < len)
+    {
+        int a = sch_strcodec_base64_value((unsigned char)in[i]);
+        int b = sch_strcodec_base64_value((unsigned char)in[i + 1]);
+        int c = len - i == 3 ? sch_strcodec_base64_value((unsigned char)in[i + 2]) : 0;
+        uint32_t group;
+        if ((a | b | c) < 0)
+        {
+            return 0;
+        }
+        group = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6);
+        out[i / 4 * 3] = (unsigned char)(group >> 16);
+        if (len - i == 3)
+        {
+            out[i / 4 * 3 + 1] = (unsigned char)(group >> 8);
+        }
+    }
+
+    bytes->size += out_len;
+    return 1;
+}
+
+void dstrcodecisa(int isa)
+{
+    assert(isa >= SCH_STRCODEC_SCALAR && isa <= SCH_STRCODEC_AVX2);
+
+    sch_strcodec_max_isa = isa;
+}
+
+#endif // SCH_IMPL && !SCH_STRCODEC_IMPL
@@ -0,0 +1,814 @@
+/*
+ * Purpose:         Single-header library for replacing and escaping text in dynamic strings.
+ * Date created:    October 2026
+ * Written by:      sch contributors
+ * License:         CC0 (public domain)
+ * Dependencies:    <stddef.h>, <stdint.h>, <string.h>, <assert.h>, <emmintrin.h> (SSE2 only), "sch_string.h"
+*/
+
+/*
+ * Usage:
+ * Define SCH_IMPL before including this file in *one* C file to create the implementation.
+ *
+ * Every function works on a string_t in place: replacing substrings, and escaping or unescaping it for JSON
+ * string literals, CSV fields and URLs. The unescaping functions leave the string unchanged if it is malformed.
+ *
+ * For example:
+
+string_t field;
+dstrnew(&field, "say \"hi\", then leave");
+dstrescapecsv(&field);                  // "say ""hi"", then leave" (with the quotes)
+if (!dstrunescapecsv(&field))
+{
+    // not a valid CSV field
+}
+dstrreplace(&field, "leave", "stay");   // 1
+dstrfree(&field);
+
+ *
+*/
+
+#ifndef SCH_STRESCAPE_H
+#define SCH_STRESCAPE_H
+
+// Definitions ===============================================
+
+#ifndef SCH_API_BEGIN
+# ifdef __cplusplus
+#  define SCH_API_BEGIN extern "C" {
+#  define SCH_API_END   }
+# else
+#  define SCH_API_BEGIN
+#  define SCH_API_END
+# endif // __cplusplus
+#endif // SCH_API_BEGIN
+
+// Includes ==================================================
+
+#include <stddef.h> // for size_t
+#include "sch_string.h"
+
+SCH_API_BEGIN // Begin extern "C" block
+
+// Functions =================================================
+
+/// Replaces every occurrence of a substring in a string_t struct, scanning left to right. The string grows at most once.
+/// @param str The string to modify.
+/// @param from The substring to replace. (must not be empty; may point into str)
+/// @param to The replacement. (may point into str)
+/// @return The number of replacements made.
+size_t dstrreplace(string_t *str, const char *from, const char *to);
+
+/// Escapes a string_t struct in place for use inside a JSON string literal (without the surrounding quotes).
+/// Quotes, backslashes and control characters are escaped. The string grows at most once, and not at all if nothing needs escaping.
+/// @param str The string to escape.
+void dstrescapejson(string_t *str);
+
+/// Unescapes the contents of a JSON string literal in place. \u escapes (including surrogate pairs) are decoded to UTF-8.
+/// @param str The string to unescape.
+/// @return 1 on success, 0 if the string contains a malformed escape or \u0000. (the string is left unchanged)
+int dstrunescapejson(string_t *str);
+
+/// Escapes a string_t struct in place as a CSV field (RFC 4180).
+/// If the string contains a comma, quote, CR or LF it is wrapped in quotes and its quotes are doubled, otherwise it is left unchanged.
+/// @param str The string to escape.
+void dstrescapecsv(string_t *str);
+
+/// Unescapes a CSV field in place. Quoted fields have their quotes removed and doubled quotes collapsed, unquoted fields are left unchanged.
+/// @param str The string to unescape.
+/// @return 1 on success, 0 if the field is quoted but malformed. (the string is left unchanged)
+int dstrunescapecsv(string_t *str);
+
+/// Percent-encodes a string_t struct in place (RFC 3986). Every byte except A-Z a-z 0-9 - . _ ~ is encoded.
+/// @param str The string to encode.
+void dstrurlencode(string_t *str);
+
+/// Decodes percent-encoded bytes in a string_t struct in place. '+' is left as is.
+/// @param str The string to decode.
+/// @return 1 on success, 0 if the string contains a malformed escape or %00. (the string is left unchanged)
+int dstrurldecode(string_t *str);
+
+SCH_API_END // End extern "C" block
+
+#endif // SCH_STRESCAPE_H
+
+#if defined(SCH_IMPL) && !defined(SCH_STRESCAPE_IMPL)
+#define SCH_STRESCAPE_IMPL
+
+// Implementation =============================================
+// Each transform first measures its output, so the string grows at most once. When it grows,
+// the old contents are moved to the tail of the new buffer and the output is written from the
+// front: the write position can never overtake the read position, so no scratch copy is needed.
+// Runs of bytes that need no change are found 16 at a time with SSE2 and copied in bulk.
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#if defined(__SSE2__)
+# include <emmintrin.h>
+# define SCH_STRESCAPE_SSE2
+#endif // __SSE2__
+
+/// Grow str to hold new_len bytes and move its old_len bytes of content to the end.
+/// @return The start of the buffer. The old contents begin at new_len - old_len.
+static char *sch_strescape_expand_tail(string_t *str, size_t old_len, size_t new_len)
+{
+    char *data;
+
+    sch_dstr_grow_if_needed(str, new_len);
+    data = sch_dstr_data(str);
+    memmove(data + (new_len - old_len), data, old_len);
+    return data;
+}
+
+inline static int sch_strescape_ctz32(uint32_t v)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(v);
+#else
+    int n = 0;
+    while (!(v & 1))
+    {
+        v >>= 1;
+        n++;
+    }
+    return n;
+#endif // __GNUC__
+}
+
+static const char sch_strescape_hex_digits[] = "0123456789ABCDEF";
+
+inline static int sch_strescape_hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    c = (char)(c | 0x20);
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/// Find the first occurrence of a needle, filtering candidates on its first and last byte.
+static const char *sch_strescape_find(const char *p, const char *end, const char *needle, size_t n)
+{
+    const char *last_start;
+
+    if ((size_t)(end - p) < n)
+    {
+        return end;
+    }
+    last_start = end - n;
+
+#ifdef SCH_STRESCAPE_SSE2
+    if (n > 1)
+    {
+        const __m128i first = _mm_set1_epi8(needle[0]);
+        const __m128i last = _mm_set1_epi8(needle[n - 1]);
+        while (last_start - p >= 15)
+        {
+            __m128i a = _mm_loadu_si128((const __m128i *)p);
+            __m128i b = _mm_loadu_si128((const __m128i *)(p + n - 1));
+            uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last)));
+            while (mask)
+            {
+                int i = sch_strescape_ctz32(mask);
+                if (memcmp(p + i + 1, needle + 1, n - 2) == 0)
+                {
+                    return p + i;
+                }
+                mask &= mask - 1;
+            }
+            p += 16;
+        }
+    }
+#endif // SCH_STRESCAPE_SSE2
+
+    while (p <= last_start)
+    {
+        p = (const char *)memchr(p, needle[0], (size_t)(last_start - p) + 1);
+        if (p == NULL)
+        {
+            return end;
+        }
+        if (memcmp(p + 1, needle + 1, n - 1) == 0)
+        {
+            return p;
+        }
+        p++;
+    }
+    return end;
+}
+
+/// Whether p points into the contents of str, which growing may move and replacing rewrites.
+static int sch_strescape_points_into(string_t *str, const char *p)
+{
+    uintptr_t offset = (uintptr_t)p - (uintptr_t)sch_dstr_data(str);
+    return offset <= dstrlen(str);
+}
+
+size_t dstrreplace(string_t *str, const char *from, const char *to)
+{
+    size_t from_len, to_len, len, new_len, i, count = 0;
+    const char *src, *src_end, *match;
+    char *data, *w;
+    string_t copy;
+    int copied = 0;
+
+    assert(str);
+    assert(from && *from);
+    assert(to);
+
+    from_len = strlen(from);
+    to_len = strlen(to);
+    len = dstrlen(str);
+
+    src = dstrc(str);
+    src_end = src + len;
+    while ((match = sch_strescape_find(src, src_end, from, from_len)) != src_end)
+    {
+        count++;
+        src = match + from_len;
+    }
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    // Patterns taken from the string itself are copied out first, to a stack string if they are short enough.
+    if (sch_strescape_points_into(str, from) || sch_strescape_points_into(str, to))
+    {
+        dstrnew(&copy, NULL);
+        dstrcatn(&copy, from, from_len);
+        dstrcatn(&copy, to, to_len);
+        from = dstrc(&copy);
+        to = from + from_len;
+        copied = 1;
+    }
+
+    sch_dstr_invalidate_hash(str);
+    new_len = len - count * from_len + count * to_len;
+    if (new_len > len)
+    {
+        data = sch_strescape_expand_tail(str, len, new_len);
+        src = data + (new_len - len);
+    }
+    else
+    {
+        data = sch_dstr_data(str);
+        src = data;
+    }
+
+    src_end = src + len;
+    w = data;
+    for (i = 0; i < count; i++)
+    {
+        match = sch_strescape_find(src, src_end, from, from_len);
+        memmove(w, src, (size_t)(match - src));
+        w += match - src;
+        memcpy(w, to, to_len);
+        w += to_len;
+        src = match + from_len;
+    }
+    memmove(w, src, (size_t)(src_end - src));
+
+    sch_dstr_set_len(str, new_len);
+    if (copied)
+    {
+        dstrfree(&copy);
+    }
+    return count;
+}
+
+// JSON ------------------------------------------------------
+
+/// The letter after the backslash for each byte that JSON escapes ('u' for the \u00XX form), 0 for the rest.
+/// A table rather than a switch, because escape-heavy input would mispredict the switch's jump on most escapes.
+static const char sch_strescape_json_escapes[0x60] = {
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    ['"'] = '"',
+    ['\\'] = '\\',
+};
+
+inline static char sch_strescape_json_escape(unsigned char c)
+{
+    return c < sizeof(sch_strescape_json_escapes) ? sch_strescape_json_escapes[c] : 0;
+}
+
+static const char *sch_strescape_scan_json(const char *p, const char *end)
+{
+#ifdef SCH_STRESCAPE_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+    while (end - p >= 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                    _mm_cmpeq_epi8(_mm_min_epu8(v, control), v));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(hits);
+        if (mask)
+        {
+            return p + sch_strescape_ctz32(mask);
+        }
+        p += 16;
+    }
+#endif // SCH_STRESCAPE_SSE2
+
+    while (p < end && !sch_strescape_json_escape((unsigned char)*p))
+    {
+        p++;
+    }
+    return p;
+}
+
+void dstrescapejson(string_t *str)
+{
+    size_t len, extra = 0;
+    const char *src, *src_end;
+    char *data, *w;
+
+    assert(str);
+
+    len = dstrlen(str);
+    src = dstrc(str);
+    src_end = src + len;
+    while ((src = sch_strescape_scan_json(src, src_end)) != src_end)
+    {
+        extra += sch_strescape_json_escape((unsigned char)*src) == 'u' ? 5 : 1;
+        src++;
+    }
+    if (extra == 0)
+    {
+        return;
+    }
+
+    sch_dstr_invalidate_hash(str);
+    data = sch_strescape_expand_tail(str, len, len + extra);
+    src = data + extra;
+    src_end = src + len;
+    w = data;
+    for (;;)
+    {
+        const char *run_end = sch_strescape_scan_json(src, src_end);
+        unsigned char c;
+        char escape;
+
+        memmove(w, src, (size_t)(run_end - src));
+        w += run_end - src;
+        src = run_end;
+        if (src == src_end)
+        {
+            break;
+        }
+
+        c = (unsigned char)*src++;
+        escape = sch_strescape_json_escape(c);
+        *w++ = '\\';
+        *w++ = escape;
+        if (escape == 'u')
+        {
+            *w++ = '0';
+            *w++ = '0';
+            *w++ = sch_strescape_hex_digits[c >> 4];
+            *w++ = sch_strescape_hex_digits[c & 0xF];
+        }
+    }
+
+    sch_dstr_set_len(str, len + extra);
+}
+
+inline static long sch_strescape_hex4(const char *p)
+{
+    long value = 0;
+    int i;
+    for (i = 0; i < 4; i++)
+    {
+        int digit = sch_strescape_hex_value(p[i]);
+        if (digit < 0)
+        {
+            return -1;
+        }
+        value = value * 16 + digit;
+    }
+    return value;
+}
+
+/// Unescape JSON from src into dst (which may equal src), or only validate and measure if dst is NULL.
+static int sch_strescape_json_unescape(char *dst, const char *src, size_t n, size_t *out_len)
+{
+    const char *p = src;
+    const char *end = src + n;
+    size_t w = 0;
+
+    for (;;)
+    {
+        const char *q = (const char *)memchr(p, '\\', (size_t)(end - p));
+        unsigned long cp;
+        char c;
+
+        if (q == NULL)
+        {
+            q = end;
+        }
+        if (dst)
+        {
+            memmove(dst + w, p, (size_t)(q - p));
+        }
+        w += (size_t)(q - p);
+        p = q;
+        if (p == end)
+        {
+            break;
+        }
+        if (end - p < 2)
+        {
+            return 0;
+        }
+
+        c = p[1];
+        p += 2;
+        switch (c)
+        {
+        case '"': case '\\': case '/': break;
+        case 'b': c = '\b'; break;
+        case 'f': c = '\f'; break;
+        case 'n': c = '\n'; break;
+        case 'r': c = '\r'; break;
+        case 't': c = '\t'; break;
+        case 'u':
+        {
+            long hi, lo;
+            if (end - p < 4 || (hi = sch_strescape_hex4(p)) <= 0)
+            {
+                return 0;
+            }
+            p += 4;
+            cp = (unsigned long)hi;
+            if (hi >= 0xD800 && hi <= 0xDBFF)
+            {
+                if (end - p < 6 || p[0] != '\\' || p[1] != 'u' || (lo = sch_strescape_hex4(p + 2)) < 0xDC00 || lo > 0xDFFF)
+                {
+                    return 0;
+                }
+                p += 6;
+                cp = 0x10000 + (((unsigned long)hi - 0xD800) << 10) + ((unsigned long)lo - 0xDC00);
+            }
+            else if (hi >= 0xDC00 && hi <= 0xDFFF)
+            {
+                return 0;
+            }
+
+            if (cp < 0x80)
+            {
+                if (dst)
+                {
+                    dst[w] = (char)cp;
+                }
+                w += 1;
+            }
+            else if (cp < 0x800)
+            {
+                if (dst)
+                {
+                    dst[w] = (char)(0xC0 | (cp >> 6));
+                    dst[w + 1] = (char)(0x80 | (cp & 0x3F));
+                }
+                w += 2;
+            }
+            else if (cp < 0x10000)
+            {
+                if (dst)
+                {
+                    dst[w] = (char)(0xE0 | (cp >> 12));
+                    dst[w + 1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+                    dst[w + 2] = (char)(0x80 | (cp & 0x3F));
+                }
+                w += 3;
+            }
+            else
+            {
+                if (dst)
+                {
+                    dst[w] = (char)(0xF0 | (cp >> 18));
+                    dst[w + 1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+                    dst[w + 2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+                    dst[w + 3] = (char)(0x80 | (cp & 0x3F));
+                }
+                w += 4;
+            }
+            continue;
+        }
+        default:
+            return 0;
+        }
+
+        if (dst)
+        {
+            dst[w] = c;
+        }
+        w++;
+    }
+
+    *out_len = w;
+    return 1;
+}
+
+int dstrunescapejson(string_t *str)
+{
+    size_t len, new_len;
+
+    assert(str);
+
+    len = dstrlen(str);
+    if (!sch_strescape_json_unescape(NULL, dstrc(str), len, &new_len))
+    {
+        return 0;
+    }
+    if (new_len != len)
+    {
+        char *data = sch_dstr_data(str);
+        sch_dstr_invalidate_hash(str);
+        sch_strescape_json_unescape(data, data, len, &new_len);
+        sch_dstr_set_len(str, new_len);
+    }
+    return 1;
+}
+
+// CSV -------------------------------------------------------
+
+static const char *sch_strescape_scan_csv(const char *p, const char *end)
+{
+#ifdef SCH_STRESCAPE_SSE2
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+    while (end - p >= 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, quote)),
+                                    _mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, lf)));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(hits);
+        if (mask)
+        {
+            return p + sch_strescape_ctz32(mask);
+        }
+        p += 16;
+    }
+#endif // SCH_STRESCAPE_SSE2
+
+    while (p < end && *p != ',' && *p != '"' && *p != '\r' && *p != '\n')
+    {
+        p++;
+    }
+    return p;
+}
+
+void dstrescapecsv(string_t *str)
+{
+    size_t len, quotes = 0;
+    const char *src, *src_end;
+    char *data, *w;
+
+    assert(str);
+
+    len = dstrlen(str);
+    src = dstrc(str);
+    src_end = src + len;
+    if (sch_strescape_scan_csv(src, src_end) == src_end)
+    {
+        return;
+    }
+    while ((src = (const char *)memchr(src, '"', (size_t)(src_end - src))) != NULL)
+    {
+        quotes++;
+        src++;
+    }
+
+    sch_dstr_invalidate_hash(str);
+    data = sch_strescape_expand_tail(str, len, len + quotes + 2);
+    src = data + quotes + 2;
+    src_end = src + len;
+    w = data;
+    *w++ = '"';
+    for (;;)
+    {
+        const char *q = (const char *)memchr(src, '"', (size_t)(src_end - src));
+        const char *run_end = q ? q + 1 : src_end;
+
+        memmove(w, src, (size_t)(run_end - src));
+        w += run_end - src;
+        src = run_end;
+        if (q == NULL)
+        {
+            break;
+        }
+        *w++ = '"';
+    }
+    *w = '"';
+
+    sch_dstr_set_len(str, len + quotes + 2);
+}
+
+int dstrunescapecsv(string_t *str)
+{
+    size_t len, quotes = 0;
+    const char *p, *end;
+    char *data, *w;
+
+    assert(str);
+
+    len = dstrlen(str);
+    p = dstrc(str);
+    if (len == 0 || p[0] != '"')
+    {
+        return 1;
+    }
+    if (len < 2 || p[len - 1] != '"')
+    {
+        return 0;
+    }
+
+    // Every quote inside must be doubled.
+    end = p + len - 1;
+    p++;
+    while ((p = (const char *)memchr(p, '"', (size_t)(end - p))) != NULL)
+    {
+        if (p + 1 >= end || p[1] != '"')
+        {
+            return 0;
+        }
+        quotes++;
+        p += 2;
+    }
+
+    sch_dstr_invalidate_hash(str);
+    data = sch_dstr_data(str);
+    p = data + 1;
+    end = data + len - 1;
+    w = data;
+    for (;;)
+    {
+        const char *q = (const char *)memchr(p, '"', (size_t)(end - p));
+        const char *run_end = q ? q + 1 : end;
+
+        memmove(w, p, (size_t)(run_end - p));
+        w += run_end - p;
+        if (q == NULL)
+        {
+            break;
+        }
+        p = q + 2;
+    }
+
+    sch_dstr_set_len(str, len - 2 - quotes);
+    return 1;
+}
+
+// URL -------------------------------------------------------
+
+inline static int sch_strescape_url_unreserved(unsigned char c)
+{
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '.' || c == '_' || c == '~';
+}
+
+#ifdef SCH_STRESCAPE_SSE2
+/// Bytes of v that lie in [lo, hi], as a byte mask.
+inline static __m128i sch_strescape_in_range(__m128i v, char lo, char hi)
+{
+    __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8((char)(hi - lo))), shifted);
+}
+#endif // SCH_STRESCAPE_SSE2
+
+static const char *sch_strescape_scan_url(const char *p, const char *end)
+{
+#ifdef SCH_STRESCAPE_SSE2
+    while (end - p >= 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        __m128i ok = _mm_or_si128(sch_strescape_in_range(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 'z'), sch_strescape_in_range(v, '0', '9'));
+        uint32_t mask;
+        ok = _mm_or_si128(ok, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('-')), _mm_cmpeq_epi8(v, _mm_set1_epi8('.'))));
+        ok = _mm_or_si128(ok, _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('_')), _mm_cmpeq_epi8(v, _mm_set1_epi8('~'))));
+        mask = ~(uint32_t)_mm_movemask_epi8(ok) & 0xFFFF;
+        if (mask)
+        {
+            return p + sch_strescape_ctz32(mask);
+        }
+        p += 16;
+    }
+#endif // SCH_STRESCAPE_SSE2
+
+    while (p < end && sch_strescape_url_unreserved((unsigned char)*p))
+    {
+        p++;
+    }
+    return p;
+}
+
+void dstrurlencode(string_t *str)
+{
+    size_t len, extra = 0;
+    const char *src, *src_end;
+    char *data, *w;
+
+    assert(str);
+
+    len = dstrlen(str);
+    src = dstrc(str);
+    src_end = src + len;
+    while ((src = sch_strescape_scan_url(src, src_end)) != src_end)
+    {
+        extra += 2;
+        src++;
+    }
+    if (extra == 0)
+    {
+        return;
+    }
+
+    sch_dstr_invalidate_hash(str);
+    data = sch_strescape_expand_tail(str, len, len + extra);
+    src = data + extra;
+    src_end = src + len;
+    w = data;
+    for (;;)
+    {
+        const char *run_end = sch_strescape_scan_url(src, src_end);
+        unsigned char c;
+
+        memmove(w, src, (size_t)(run_end - src));
+        w += run_end - src;
+        src = run_end;
+        if (src == src_end)
+        {
+            break;
+        }
+
+        c = (unsigned char)*src++;
+        *w++ = '%';
+        *w++ = sch_strescape_hex_digits[c >> 4];
+        *w++ = sch_strescape_hex_digits[c & 0xF];
+    }
+
+    sch_dstr_set_len(str, len + extra);
+}
+
+int dstrurldecode(string_t *str)
+{
+    size_t len, escapes = 0;
+    const char *p, *end;
+    char *data, *w;
+
+    assert(str);
+
+    len = dstrlen(str);
+    p = dstrc(str);
+    end = p + len;
+    while ((p = (const char *)memchr(p, '%', (size_t)(end - p))) != NULL)
+    {
+        int hi, lo;
+        if (end - p < 3 || (hi = sch_strescape_hex_value(p[1])) < 0 || (lo = sch_strescape_hex_value(p[2])) < 0 || (hi | lo) == 0)
+        {
+            return 0;
+        }
+        escapes++;
+        p += 3;
+    }
+    if (escapes == 0)
+    {
+        return 1;
+    }
+
+    sch_dstr_invalidate_hash(str);
+    data = sch_dstr_data(str);
+    p = data;
+    end = data + len;
+    w = data;
+    for (;;)
+    {
+        const char *q = (const char *)memchr(p, '%', (size_t)(end - p));
+        const char *run_end = q ? q : end;
+
+        memmove(w, p, (size_t)(run_end - p));
+        w += run_end - p;
+        if (q == NULL)
+        {
+            break;
+        }
+        *w++ = (char)(sch_strescape_hex_value(q[1]) * 16 + sch_strescape_hex_value(q[2]));
+        p = q + 3;
+    }
+
+    sch_dstr_set_len(str, len - escapes * 2);
+    return 1;
+}
+
+#endif // SCH_IMPL && !SCH_STRESCAPE_IMPL
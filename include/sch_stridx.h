@@ -0,0 +1,449 @@
+/*
+ * Purpose:         Single-header library for substring indexes over large dynamic strings.
+ * Date created:    October 2026
+ * Written by:      sch contributors
+ * License:         CC0 (public domain)
+ * Dependencies:    <stddef.h>, <stdint.h>, <string.h>, <assert.h>, "sch_array.h", "sch_string.h"
+*/
+
+/*
+ * Usage:
+ * Define SCH_IMPL before including this file in *one* C file to create the implementation.
+ *
+ * A substring index remembers where every SCH_STRIDX_GRAM byte sequence (gram) of a string_t occurs,
+ * so repeated searches in a large string only visit the places where the rarest gram of the needle
+ * occurs instead of rescanning the whole string.
+ * The index is built by the first query and extended by later queries when the string has been appended to,
+ * so only the appended bytes are indexed again.
+ *
+ * For example:
+
+stridx_t idx;
+stridxnew(&idx, SCH_STRIDX_MIN_LEN);                 // strings shorter than the default are just scanned
+
+size_t pos = stridxfind(&idx, &doc, "needle", 6);    // builds the index, then looks up "needle"
+size_t n = stridxcount(&idx, &doc, "needle", 6);     // reuses the index
+
+dstrcat(&doc, more_text);
+pos = stridxfind(&idx, &doc, "needle", 6);           // indexes only more_text before looking up
+
+size_t overhead = stridxmem(&idx);                   // bytes used by the index
+
+stridxfree(&idx);
+
+ * A lookup costs time proportional to the needle's length plus the number of places its rarest gram
+ * occurs, independent of the string's length. The index costs 4 bytes per byte of the string plus an 8 byte
+ * bucket for every 1 to 2 bytes, and grows by doubling like a sch_dar, so expect 8 to 16 bytes per byte
+ * of the string. (stridxmem gives the exact figure)
+ * Needles shorter than SCH_STRIDX_GRAM, and strings shorter than the threshold given to stridxnew,
+ * are searched with a plain scan instead.
+ *
+ * The index only notices appends. After any other change to the string, call stridxclr.
+ * (Shrinking the string or changing its last indexed bytes is detected and causes a rebuild.)
+ * The index does not keep a pointer to the string, pass the same string to every query.
+ *
+*/
+
+#ifndef SCH_STRIDX_H
+#define SCH_STRIDX_H
+
+// Definitions ===============================================
+
+#ifndef SCH_API_BEGIN
+# ifdef __cplusplus
+#  define SCH_API_BEGIN extern "C" {
+#  define SCH_API_END   }
+# else
+#  define SCH_API_BEGIN
+#  define SCH_API_END
+# endif // __cplusplus
+#endif // SCH_API_BEGIN
+
+// Includes ==================================================
+
+#include <stddef.h> // for size_t
+#include <stdint.h> // for uint32_t, uint64_t
+#include "sch_array.h"
+#include "sch_string.h"
+
+SCH_API_BEGIN // Begin extern "C" block
+
+// Constants =================================================
+
+/// The length of the grams the index is keyed by. (1 to 8)
+/// Longer grams make lookups more selective, but needles shorter than a gram are scanned for.
+#ifndef SCH_STRIDX_GRAM
+# define SCH_STRIDX_GRAM 4
+#endif // SCH_STRIDX_GRAM
+
+/// A threshold for stridxnew below which a plain scan is usually faster than building an index.
+#ifndef SCH_STRIDX_MIN_LEN
+# define SCH_STRIDX_MIN_LEN 4096
+#endif // SCH_STRIDX_MIN_LEN
+
+/// Returned by stridxfind when the needle does not occur.
+#define SCH_STRIDX_NONE ((size_t)-1)
+
+// Types =====================================================
+
+/// One hash bucket: the most recent position whose gram hashes here (plus one, 0 if none) and the number of such positions.
+struct sch_stridx_bucket
+{
+    uint32_t head;
+    uint32_t count;
+};
+
+/// A substring index over a string_t.
+/// next.data[p] links position p to the previous position in the same bucket (plus one, 0 if none),
+/// and next.size is the number of positions indexed so far.
+typedef struct sch_stridx
+{
+    size_t min_len; // strings shorter than this are scanned, not indexed
+    uint64_t last;  // the gram at position next.size - 1, to notice when the indexed bytes change
+    unsigned bits;  // log2 of the number of buckets
+    struct
+    {
+        size_t size;
+        size_t capacity;
+        struct sch_stridx_bucket *data;
+    } buckets;
+    struct
+    {
+        size_t size;
+        size_t capacity;
+        uint32_t *data;
+    } next;
+} stridx_t;
+
+// Functions =================================================
+
+/// Initializes a stridx_t struct. Nothing is allocated until the index is first built.
+/// @param idx The index to initialize.
+/// @param min_len Strings shorter than this are scanned instead of indexed. (e.g. SCH_STRIDX_MIN_LEN)
+void stridxnew(stridx_t *idx, size_t min_len);
+
+/// Frees the memory used by a stridx_t struct.
+/// @param idx The index to free.
+void stridxfree(stridx_t *idx);
+
+/// Forgets everything indexed so far, keeping the memory. Call this after changing the string other than by appending.
+/// @param idx The index to clear.
+void stridxclr(stridx_t *idx);
+
+/// Brings a stridx_t struct up to date with a string now instead of on the next query.
+/// @param idx The index.
+/// @param str The indexed string.
+void stridxsync(stridx_t *idx, const string_t *str);
+
+/// Finds the first occurrence of a needle in a string, using and updating the index.
+/// @param idx The index.
+/// @param str The indexed string.
+/// @param needle The bytes to look for.
+/// @param len The length of the needle. (must be greater than 0)
+/// @return The offset of the first occurrence, or SCH_STRIDX_NONE.
+size_t stridxfind(stridx_t *idx, const string_t *str, const char *needle, size_t len);
+
+/// Counts the occurrences of a needle in a string, including overlapping ones, using and updating the index.
+/// @param idx The index.
+/// @param str The indexed string.
+/// @param needle The bytes to look for.
+/// @param len The length of the needle. (must be greater than 0)
+/// @return The number of occurrences.
+size_t stridxcount(stridx_t *idx, const string_t *str, const char *needle, size_t len);
+
+/// Returns the number of bytes allocated by a stridx_t struct.
+/// @param idx The index.
+/// @return The number of bytes allocated, 0 if the index has never been built.
+size_t stridxmem(const stridx_t *idx);
+
+SCH_API_END // End extern "C" block
+
+#endif // SCH_STRIDX_H
+
+#if defined(SCH_IMPL) && !defined(SCH_STRIDX_IMPL)
+#define SCH_STRIDX_IMPL
+
+// Implementation =============================================
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#if SCH_STRIDX_GRAM < 1 || SCH_STRIDX_GRAM > 8
+# error "SCH_STRIDX_GRAM must be between 1 and 8"
+#endif // SCH_STRIDX_GRAM
+
+#define SCH_STRIDX_MIN_BITS 10
+
+/// The gram starting at p. Grams are compared by value, so equal values mean equal bytes.
+inline static uint64_t sch_stridx_gram(const char *p)
+{
+    uint64_t gram = 0;
+    memcpy(&gram, p, SCH_STRIDX_GRAM);
+    return gram;
+}
+
+inline static size_t sch_stridx_bucket_of(const stridx_t *idx, uint64_t gram)
+{
+    return (size_t)((gram * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - idx->bits));
+}
+
+/// The number of gram positions in a string of the given length, or 0 if it should not be indexed.
+inline static size_t sch_stridx_positions(const stridx_t *idx, size_t len)
+{
+    if (len < idx->min_len || len < SCH_STRIDX_GRAM || len - SCH_STRIDX_GRAM + 1 >= UINT32_MAX)
+    {
+        return 0;
+    }
+    return len - SCH_STRIDX_GRAM + 1;
+}
+
+inline static void sch_stridx_insert(stridx_t *idx, const char *data, size_t pos)
+{
+    struct sch_stridx_bucket *bucket = &idx->buckets.data[sch_stridx_bucket_of(idx, sch_stridx_gram(data + pos))];
+    idx->next.data[pos] = bucket->head;
+    bucket->head = (uint32_t)(pos + 1);
+    bucket->count++;
+}
+
+/// Resize the bucket table to fit n positions and reinsert the positions indexed so far.
+static void sch_stridx_rehash(stridx_t *idx, const char *data, size_t n)
+{
+    size_t pos;
+    unsigned bits = SCH_STRIDX_MIN_BITS;
+
+    while (((size_t)1 << bits) < n)
+    {
+        bits++;
+    }
+
+    idx->bits = bits;
+    darres(&idx->buckets, (size_t)1 << bits);
+    idx->buckets.size = (size_t)1 << bits;
+    memset(idx->buckets.data, 0, idx->buckets.size * sizeof(*idx->buckets.data));
+
+    // Reinsert in increasing order so every chain still runs from the newest position to the oldest.
+    for (pos = 0; pos < idx->next.size; pos++)
+    {
+        sch_stridx_insert(idx, data, pos);
+    }
+}
+
+/// Plain search for the first occurrence of needle at or after from.
+static size_t sch_stridx_scan(const char *data, size_t size, const char *needle, size_t len, size_t from)
+{
+    const char *p = data + from;
+    const char *end = data + size;
+
+    while (len <= (size_t)(end - p))
+    {
+        p = (const char *)memchr(p, needle[0], (size_t)(end - p) - len + 1);
+        if (p == NULL)
+        {
+            break;
+        }
+        if (memcmp(p + 1, needle + 1, len - 1) == 0)
+        {
+            return (size_t)(p - data);
+        }
+        p++;
+    }
+    return SCH_STRIDX_NONE;
+}
+
+/// Find the gram of the needle that occurs at the fewest positions of the string.
+/// @return 0 if some gram of the needle never occurs, so neither does the needle.
+static int sch_stridx_rarest(const stridx_t *idx, const char *needle, size_t len, size_t *offset, uint64_t *gram)
+{
+    size_t k;
+    uint32_t best = UINT32_MAX;
+
+    for (k = 0; k + SCH_STRIDX_GRAM <= len; k++)
+    {
+        uint64_t g = sch_stridx_gram(needle + k);
+        const struct sch_stridx_bucket *bucket = &idx->buckets.data[sch_stridx_bucket_of(idx, g)];
+        if (bucket->count < best)
+        {
+            best = bucket->count;
+            *offset = k;
+            *gram = g;
+            if (best == 0)
+            {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+/// Walk the chain of the needle's rarest gram, verifying each candidate.
+/// @return The first occurrence (count_all == 0) or the number of occurrences (count_all != 0).
+static size_t sch_stridx_lookup(const stridx_t *idx, const char *data, size_t size, const char *needle, size_t len, int count_all)
+{
+    size_t offset = 0;
+    uint64_t gram = 0;
+    size_t first = SCH_STRIDX_NONE;
+    size_t count = 0;
+    uint32_t link;
+
+    if (!sch_stridx_rarest(idx, needle, len, &offset, &gram))
+    {
+        return count_all ? 0 : SCH_STRIDX_NONE;
+    }
+
+    // Chains run from the newest position to the oldest, so the last match seen is the first in the string.
+    for (link = idx->buckets.data[sch_stridx_bucket_of(idx, gram)].head; link != 0; link = idx->next.data[link - 1])
+    {
+        size_t pos = link - 1;
+        if (pos < offset || pos - offset + len > size || sch_stridx_gram(data + pos) != gram)
+        {
+            continue;
+        }
+        if (memcmp(data + pos - offset, needle, len) == 0)
+        {
+            first = pos - offset;
+            count++;
+        }
+    }
+
+    return count_all ? count : first;
+}
+
+void stridxnew(stridx_t *idx, size_t min_len)
+{
+    assert(idx);
+
+    memset(idx, 0, sizeof(*idx));
+    idx->min_len = min_len;
+}
+
+void stridxfree(stridx_t *idx)
+{
+    assert(idx);
+
+    darfree(&idx->buckets);
+    darfree(&idx->next);
+    idx->bits = 0;
+}
+
+void stridxclr(stridx_t *idx)
+{
+    assert(idx);
+
+    idx->next.size = 0;
+    if (idx->buckets.size > 0)
+    {
+        memset(idx->buckets.data, 0, idx->buckets.size * sizeof(*idx->buckets.data));
+    }
+}
+
+void stridxsync(stridx_t *idx, const string_t *str)
+{
+    const char *data;
+    size_t n, pos;
+
+    assert(idx);
+    assert(str);
+
+    n = sch_stridx_positions(idx, dstrlen(str));
+    if (n == 0)
+    {
+        // The string shrank below the threshold, so what was indexed can't be trusted if it grows back.
+        if (idx->next.size > 0)
+        {
+            stridxclr(idx);
+        }
+        return;
+    }
+
+    data = dstrc(str);
+    pos = idx->next.size;
+    if (pos > 0 && (pos > n || sch_stridx_gram(data + pos - 1) != idx->last))
+    {
+        stridxclr(idx);
+        pos = 0;
+    }
+    if (pos == n)
+    {
+        return;
+    }
+
+    if (n > idx->next.capacity)
+    {
+        darres(&idx->next, n > idx->next.capacity * 2 ? n : idx->next.capacity * 2);
+    }
+    if (n > idx->buckets.size * 2)
+    {
+        sch_stridx_rehash(idx, data, n);
+    }
+
+    for (; pos < n; pos++)
+    {
+        sch_stridx_insert(idx, data, pos);
+    }
+    idx->next.size = n;
+    idx->last = sch_stridx_gram(data + n - 1);
+}
+
+size_t stridxfind(stridx_t *idx, const string_t *str, const char *needle, size_t len)
+{
+    size_t size;
+
+    assert(idx);
+    assert(str);
+    assert(needle);
+    assert(len > 0);
+
+    size = dstrlen(str);
+    if (len < SCH_STRIDX_GRAM || sch_stridx_positions(idx, size) == 0)
+    {
+        if (idx->next.size > 0 && sch_stridx_positions(idx, size) == 0)
+        {
+            stridxclr(idx);
+        }
+        return sch_stridx_scan(dstrc(str), size, needle, len, 0);
+    }
+
+    stridxsync(idx, str);
+    return sch_stridx_lookup(idx, dstrc(str), size, needle, len, 0);
+}
+
+size_t stridxcount(stridx_t *idx, const string_t *str, const char *needle, size_t len)
+{
+    size_t size;
+
+    assert(idx);
+    assert(str);
+    assert(needle);
+    assert(len > 0);
+
+    size = dstrlen(str);
+    if (len < SCH_STRIDX_GRAM || sch_stridx_positions(idx, size) == 0)
+    {
+        if (idx->next.size > 0 && sch_stridx_positions(idx, size) == 0)
+        {
+            stridxclr(idx);
+        }
+        const char *data = dstrc(str);
+        size_t count = 0;
+        size_t pos = sch_stridx_scan(data, size, needle, len, 0);
+        while (pos != SCH_STRIDX_NONE)
+        {
+            count++;
+            pos = sch_stridx_scan(data, size, needle, len, pos + 1);
+        }
+        return count;
+    }
+
+    stridxsync(idx, str);
+    return sch_stridx_lookup(idx, dstrc(str), size, needle, len, 1);
+}
+
+size_t stridxmem(const stridx_t *idx)
+{
+    assert(idx);
+
+    return idx->buckets.capacity * sizeof(*idx->buckets.data) + idx->next.capacity * sizeof(*idx->next.data);
+}
+
+#endif // SCH_IMPL && !SCH_STRIDX_IMPL
@@ -3,12 +3,19 @@
  * Date created:    November 2023
  * Written by:      Scott DiGregorio
  * License:         CC0 (public domain)
- * Dependencies:    <stddef.h>, <stdlib.h>, <string.h>, <assert.h>
+ * Dependencies:    <stddef.h>, <stdint.h>, <stdlib.h>, <string.h>, <assert.h>, "sch_recycle.h" (SCH_RECYCLE only)
 */
 
 /*
  * Usage:
  * Define SCH_IMPL before including this file in *one* C file to create the implementation.
+ *
+ * Define SCH_STRING_CACHE_HASH in the implementation file (before including this file with SCH_IMPL)
+ * to let heap strings cache their hash. It has no effect anywhere else.
+ * Each heap allocation grows by 8 bytes to hold it, and any mutation of the string invalidates it.
+ * Use dstrhashcached to read through the cache.
+ *
+ * Define SCH_RECYCLE in the implementation file to take heap buffers from the size-class recycler in "sch_recycle.h".
 */
 
 #ifndef SCH_STRING_H
@@ -31,11 +38,16 @@ SCH_API_BEGIN // Begin extern "C" block
 // Includes ==================================================
 
 #include <stddef.h> // for size_t
+#include <stdint.h> // for uint64_t
 
 // Types =====================================================
 
 #define SCH_STRING_STACK_CAPACITY ((sizeof(size_t) * 2 + sizeof(char *)) - 1)
 
+/// Set in the type member while a heap string's cached hash is valid. (see SCH_STRING_CACHE_HASH)
+/// Code that writes to a string's characters directly must clear it.
+#define SCH_DSTR_HASH_BIT ((size_t)2)
+
 /// The string_t struct is a union of two structs: heapstr and stackstr.
 /// The heapstr struct is used when the string is too large to fit on the stack.
 /// The stackstr struct is used when the string is small enough to fit on the stack.
@@ -102,6 +114,12 @@ void dstrcpyd(string_t *str, const string_t *other);
 /// @param cstr The C string to append.
 void dstrcat(string_t *str, const char *cstr);
 
+/// Appends a buffer of characters to a string_t struct. The buffer may contain null characters.
+/// @param str The string to append to.
+/// @param data The characters to append. (can be NULL if len is 0, must not point into str)
+/// @param len The number of characters to append.
+void dstrcatn(string_t *str, const char *data, size_t len);
+
 /// Appends a character to a string_t struct.
 /// @param str The string to append to.
 /// @param c The character to append.
@@ -132,11 +150,30 @@ int dstrcmp(const string_t *str, const char *cstr);
 /// @return 0 if the strings are equal, -1 if the string is less than the other string, 1 if the string is greater than the other string.
 int dstrcmpd(const string_t *str, const string_t *other);
 
+/// Hashes a string_t struct with a fast non-cryptographic hash (wyhash).
+/// The hash is not stable across byte orders and must not be used for security purposes.
+/// @param str The string to hash.
+/// @return The 64-bit hash of the string's contents.
+uint64_t dstrhash(const string_t *str);
+
+/// Hashes a string_t struct, reusing the hash cached by a previous call if the string has not changed since.
+/// Without SCH_STRING_CACHE_HASH, or for strings stored on the stack, this is the same as dstrhash.
+/// @param str The string to hash.
+/// @return The 64-bit hash of the string's contents.
+uint64_t dstrhashcached(string_t *str);
+
+/// Hashes a buffer of bytes. Gives the same result as dstrhash on a string with the same contents.
+/// @param data The bytes to hash. (can be NULL if len is 0)
+/// @param len The number of bytes to hash.
+/// @return The 64-bit hash of the bytes.
+uint64_t dstrhashn(const char *data, size_t len);
+
 SCH_API_END // End extern "C" block
 
 #endif // SCH_STRING_H
 
-#ifdef SCH_IMPL
+#if defined(SCH_IMPL) && !defined(SCH_STRING_IMPL)
+#define SCH_STRING_IMPL // headers that build on this one may include it again
 
 // Implementation =============================================
 
@@ -144,6 +181,47 @@ SCH_API_END // End extern "C" block
 #include <string.h>
 #include <assert.h>
 
+#ifdef SCH_STRING_CACHE_HASH
+# define SCH_DSTR_HEAP_EXTRA sizeof(uint64_t) // room for the cached hash after the capacity
+#else
+# define SCH_DSTR_HEAP_EXTRA 0
+#endif // SCH_STRING_CACHE_HASH
+
+#ifdef SCH_RECYCLE
+# include "sch_recycle.h"
+#endif // SCH_RECYCLE
+
+// Heap buffers go through the size-class recycler when SCH_RECYCLE is defined, and straight to malloc otherwise.
+
+inline static char *sch_dstr_heap_alloc(size_t capacity)
+{
+#ifdef SCH_RECYCLE
+    return (char *)sch_recycle_alloc(capacity + SCH_DSTR_HEAP_EXTRA);
+#else
+    return (char *)malloc(capacity + SCH_DSTR_HEAP_EXTRA);
+#endif // SCH_RECYCLE
+}
+
+inline static char *sch_dstr_heap_realloc(char *data, size_t old_capacity, size_t new_capacity)
+{
+#ifdef SCH_RECYCLE
+    return (char *)sch_recycle_realloc(data, old_capacity + SCH_DSTR_HEAP_EXTRA, new_capacity + SCH_DSTR_HEAP_EXTRA);
+#else
+    (void)old_capacity;
+    return (char *)realloc(data, new_capacity + SCH_DSTR_HEAP_EXTRA);
+#endif // SCH_RECYCLE
+}
+
+inline static void sch_dstr_heap_free(char *data, size_t capacity)
+{
+#ifdef SCH_RECYCLE
+    sch_recycle_free(data, capacity + SCH_DSTR_HEAP_EXTRA);
+#else
+    (void)capacity;
+    free(data);
+#endif // SCH_RECYCLE
+}
+
 inline static int sch_dstr_can_fit_on_stack(size_t len)
 {
     return len <= SCH_STRING_STACK_CAPACITY ? 1 : 0;
@@ -186,6 +264,11 @@ inline static int sch_dstr_is_heap(const string_t *str)
     return sch_dstr_get_type_bit(str) == 0;
 }
 
+inline static void sch_dstr_invalidate_hash(string_t *str)
+{
+    str->type &= ~SCH_DSTR_HASH_BIT;
+}
+
 inline static void sch_make_heapstr(string_t *str)
 {
     str->u.heapstr.size = 0;
@@ -209,7 +292,7 @@ inline static void sch_dstr_grow_if_needed(string_t *str, size_t len)
         {
             size_t capacity = (len + 1) * 2; // Grow by 2x to avoid reallocating too often
             size_t size = dstrlen(str);
-            char *data = (char *)malloc(capacity);
+            char *data = sch_dstr_heap_alloc(capacity);
             memcpy(data, sch_dstr_stack_data(str), size);
 
             sch_make_heapstr(str);
@@ -223,12 +306,35 @@ inline static void sch_dstr_grow_if_needed(string_t *str, size_t len)
     {
         if (len >= str->u.heapstr.capacity)
         {
-            str->u.heapstr.capacity = (len + 1) * 2; // Grow by 2x to avoid reallocating too often
-            str->u.heapstr.data = (char *)realloc(str->u.heapstr.data, str->u.heapstr.capacity);
+            size_t capacity = (len + 1) * 2; // Grow by 2x to avoid reallocating too often
+            str->u.heapstr.data = sch_dstr_heap_realloc(str->u.heapstr.data, str->u.heapstr.capacity, capacity);
+            str->u.heapstr.capacity = capacity;
         }
     }
 }
 
+inline static char *sch_dstr_data(string_t *str)
+{
+    return sch_dstr_is_stack(str) ? sch_dstr_stack_data(str) : str->u.heapstr.data;
+}
+
+inline static void sch_dstr_set_len(string_t *str, size_t len)
+{
+    if (sch_dstr_is_stack(str))
+    {
+        if (len < SCH_STRING_STACK_CAPACITY)
+        {
+            sch_dstr_stack_data(str)[len] = '\0';
+        }
+        str->u.stackstr.room = (char)(SCH_STRING_STACK_CAPACITY - len);
+    }
+    else
+    {
+        str->u.heapstr.size = len;
+        str->u.heapstr.data[len] = '\0';
+    }
+}
+
 void dstrnew(string_t *str, const char *cstr)
 {
     assert(str);
@@ -251,7 +357,7 @@ void dstrnew(string_t *str, const char *cstr)
             sch_make_heapstr(str);
             str->u.heapstr.size = len;
             str->u.heapstr.capacity = len + 1;
-            str->u.heapstr.data = (char *)malloc(str->u.heapstr.capacity);
+            str->u.heapstr.data = sch_dstr_heap_alloc(str->u.heapstr.capacity);
             memcpy(str->u.heapstr.data, cstr, len);
             str->u.heapstr.data[len] = '\0';
         }
@@ -268,7 +374,7 @@ void dstrfree(string_t *str)
 
     if (sch_dstr_is_heap(str))
     {
-        free(str->u.heapstr.data);
+        sch_dstr_heap_free(str->u.heapstr.data, str->u.heapstr.capacity);
     }
 }
 
@@ -317,6 +423,7 @@ const char *dstrc(const string_t *str)
 void dstrcpy(string_t *str, const char *cstr)
 {
     assert(str);
+    sch_dstr_invalidate_hash(str);
 
     if (cstr)
     {
@@ -329,7 +436,7 @@ void dstrcpy(string_t *str, const char *cstr)
             {
                 sch_dstr_stack_data(str)[len] = '\0';
             }
-            str->u.stackstr.room -= len;
+            str->u.stackstr.room = (char)(SCH_STRING_STACK_CAPACITY - len);
         }
         else
         {
@@ -358,30 +465,48 @@ void dstrcat(string_t *str, const char *cstr)
 
     if (cstr)
     {
-        size_t len = strlen(cstr);
-        size_t size = dstrlen(str);
-        sch_dstr_grow_if_needed(str, size + len);
-        if (sch_dstr_is_stack(str))
-        {
-            memcpy(sch_dstr_stack_data(str) + size, cstr, len);
-            if (size + len < SCH_STRING_STACK_CAPACITY)
-            {
-                sch_dstr_stack_data(str)[size + len] = '\0';
-            }
-            str->u.stackstr.room -= len;
-        }
-        else
+        dstrcatn(str, cstr, strlen(cstr));
+    }
+    else
+    {
+        sch_dstr_invalidate_hash(str);
+    }
+}
+
+void dstrcatn(string_t *str, const char *data, size_t len)
+{
+    assert(str);
+    assert(data || len == 0);
+    sch_dstr_invalidate_hash(str);
+
+    if (len == 0)
+    {
+        return;
+    }
+
+    size_t size = dstrlen(str);
+    sch_dstr_grow_if_needed(str, size + len);
+    if (sch_dstr_is_stack(str))
+    {
+        memcpy(sch_dstr_stack_data(str) + size, data, len);
+        if (size + len < SCH_STRING_STACK_CAPACITY)
         {
-            memcpy(str->u.heapstr.data + size, cstr, len);
-            str->u.heapstr.size += len;
-            str->u.heapstr.data[str->u.heapstr.size] = '\0';
+            sch_dstr_stack_data(str)[size + len] = '\0';
         }
+        str->u.stackstr.room -= len;
+    }
+    else
+    {
+        memcpy(str->u.heapstr.data + size, data, len);
+        str->u.heapstr.size += len;
+        str->u.heapstr.data[str->u.heapstr.size] = '\0';
     }
 }
 
 void dstrcatc(string_t *str, char c)
 {
     assert(str);
+    sch_dstr_invalidate_hash(str);
 
     size_t size = dstrlen(str);
     sch_dstr_grow_if_needed(str, size + 1);
@@ -413,6 +538,7 @@ void dstrcatd(string_t *str, const string_t *other)
 void dstrclr(string_t *str)
 {
     assert(str);
+    sch_dstr_invalidate_hash(str);
 
     if (sch_dstr_is_heap(str))
     {
@@ -429,6 +555,7 @@ void dstrclr(string_t *str)
 void dstrfit(string_t *str)
 {
     assert(str);
+    sch_dstr_invalidate_hash(str);
 
     if (sch_dstr_is_stack(str))
     {
@@ -444,13 +571,13 @@ void dstrfit(string_t *str)
         temp.u.stackstr.data[size] = '\0';
         temp.u.stackstr.room -= size;
 
-        free(str->u.heapstr.data);
+        sch_dstr_heap_free(str->u.heapstr.data, str->u.heapstr.capacity);
         *str = temp;
     }
     else
     {
+        str->u.heapstr.data = sch_dstr_heap_realloc(str->u.heapstr.data, str->u.heapstr.capacity, size + 1);
         str->u.heapstr.capacity = size + 1;
-        str->u.heapstr.data = (char *)realloc(str->u.heapstr.data, str->u.heapstr.capacity);
     }
 }
 
@@ -476,4 +603,149 @@ int dstrcmpd(const string_t *str, const string_t *other)
     return strcmp(dstrc(str), dstrc(other));
 }
 
-#endif // SCH_IMPL
\ No newline at end of file
+// Hashing ===================================================
+// wyhash final version 4 by Wang Yi, released into the public domain. Version 4 kept the secret of version 3,
+// the later 4.1 and 4.2 releases changed it and give different hashes. (see the reference vectors in variants/hash_cache.c)
+
+static const uint64_t sch_wyp[4] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+
+inline static void sch_wymum(uint64_t *a, uint64_t *b)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 sch_u128;
+    sch_u128 r = (sch_u128)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), lo, hi;
+    uint64_t c = t < rl;
+    lo = t + (rm1 << 32);
+    c += lo < t;
+    hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    *a = lo;
+    *b = hi;
+#endif // __SIZEOF_INT128__
+}
+
+inline static uint64_t sch_wymix(uint64_t a, uint64_t b)
+{
+    sch_wymum(&a, &b);
+    return a ^ b;
+}
+
+inline static uint64_t sch_wyr8(const unsigned char *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline static uint64_t sch_wyr4(const unsigned char *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline static uint64_t sch_wyr3(const unsigned char *p, size_t k)
+{
+    return ((uint64_t)p[0] << 16) | ((uint64_t)p[k >> 1] << 8) | p[k - 1];
+}
+
+static uint64_t sch_wyhash(const void *key, size_t len, uint64_t seed)
+{
+    const unsigned char *p = (const unsigned char *)key;
+    uint64_t a, b;
+
+    seed ^= sch_wymix(seed ^ sch_wyp[0], sch_wyp[1]);
+    if (len <= 16)
+    {
+        if (len >= 4)
+        {
+            a = (sch_wyr4(p) << 32) | sch_wyr4(p + ((len >> 3) << 2));
+            b = (sch_wyr4(p + len - 4) << 32) | sch_wyr4(p + len - 4 - ((len >> 3) << 2));
+        }
+        else if (len > 0)
+        {
+            a = sch_wyr3(p, len);
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+    else
+    {
+        size_t i = len;
+        if (i > 48)
+        {
+            // Three independent lanes keep the multipliers busy on long inputs.
+            uint64_t see1 = seed, see2 = seed;
+            do
+            {
+                seed = sch_wymix(sch_wyr8(p) ^ sch_wyp[1], sch_wyr8(p + 8) ^ seed);
+                see1 = sch_wymix(sch_wyr8(p + 16) ^ sch_wyp[2], sch_wyr8(p + 24) ^ see1);
+                see2 = sch_wymix(sch_wyr8(p + 32) ^ sch_wyp[3], sch_wyr8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+            seed = sch_wymix(sch_wyr8(p) ^ sch_wyp[1], sch_wyr8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = sch_wyr8(p + i - 16);
+        b = sch_wyr8(p + i - 8);
+    }
+
+    a ^= sch_wyp[1];
+    b ^= seed;
+    sch_wymum(&a, &b);
+    return sch_wymix(a ^ sch_wyp[0] ^ len, b ^ sch_wyp[1]);
+}
+
+uint64_t dstrhash(const string_t *str)
+{
+    assert(str);
+
+    return sch_wyhash(dstrc(str), dstrlen(str), 0);
+}
+
+uint64_t dstrhashcached(string_t *str)
+{
+    assert(str);
+
+#ifdef SCH_STRING_CACHE_HASH
+    if (sch_dstr_is_heap(str) && str->u.heapstr.data != NULL)
+    {
+        char *slot = str->u.heapstr.data + str->u.heapstr.capacity;
+        uint64_t hash;
+        if (str->type & SCH_DSTR_HASH_BIT)
+        {
+            memcpy(&hash, slot, sizeof(hash));
+            return hash;
+        }
+
+        hash = sch_wyhash(str->u.heapstr.data, str->u.heapstr.size, 0);
+        memcpy(slot, &hash, sizeof(hash));
+        str->type |= SCH_DSTR_HASH_BIT;
+        return hash;
+    }
+#endif // SCH_STRING_CACHE_HASH
+
+    return dstrhash(str);
+}
+
+uint64_t dstrhashn(const char *data, size_t len)
+{
+    assert(data || len == 0);
+
+    return sch_wyhash(data, len, 0);
+}
+
+#endif // SCH_IMPL && !SCH_STRING_IMPL
\ No newline at end of file
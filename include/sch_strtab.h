@@ -0,0 +1,432 @@
+/*
+ * Purpose:         Single-header library for packed string tables.
+ * Date created:    October 2026
+ * Written by:      sch contributors
+ * License:         CC0 (public domain)
+ * Dependencies:    <stddef.h>, <stdint.h>, <stdlib.h>, <string.h>, <assert.h>, "sch_array.h", "sch_string.h"
+*/
+
+/*
+ * Usage:
+ * Define SCH_IMPL before including this file in *one* C file to create the implementation.
+ *
+ * A string table stores many strings back to back in one growable byte buffer, plus an array of offsets.
+ * Compared to a dynamic array of string_t, each entry costs its bytes, a NUL terminator and one size_t
+ * instead of a 32 byte header and (past 23 bytes) a separate heap allocation, and scanning the whole
+ * table reads memory sequentially.
+ *
+ * For example:
+
+strtab_t column;
+strtabnew(&column, 1024);
+
+strtabpush(&column, "apple");                  // append a C string
+strtabpushn(&column, field, field_len);        // append a range of bytes
+strtabcat(&column, names, name_count);         // append many C strings with a single reservation
+
+size_t len;
+const char *s = strtabget(&column, 1, &len);   // pointer + length, also NUL-terminated
+
+size_t *order = malloc(strtabsiz(&column) * sizeof(size_t));
+strtabsort(&column, order);                    // order[k] is the index of the k-th smallest string
+
+string_t str;
+dstrnew(&str, NULL);
+strtabdstr(&column, order[0], &str);           // copy an entry out into a string_t
+
+strtabfree(&column);
+
+ * Entries are treated as text and must not contain NUL bytes.
+ * Pointers returned by strtabget are invalidated by any append.
+ *
+*/
+
+#ifndef SCH_STRTAB_H
+#define SCH_STRTAB_H
+
+// Definitions ===============================================
+
+#ifndef SCH_API_BEGIN
+# ifdef __cplusplus
+#  define SCH_API_BEGIN extern "C" {
+#  define SCH_API_END   }
+# else
+#  define SCH_API_BEGIN
+#  define SCH_API_END
+# endif // __cplusplus
+#endif // SCH_API_BEGIN
+
+// Includes ==================================================
+
+#include <stddef.h> // for size_t
+#include "sch_array.h"
+#include "sch_string.h"
+
+SCH_API_BEGIN // Begin extern "C" block
+
+// Types =====================================================
+
+/// A table of strings packed into one buffer.
+/// offsets.data[i] is where string i starts in bytes.data, and one extra trailing offset marks the end of the last string.
+/// Each string is followed by a NUL terminator, which is included in the distance between consecutive offsets.
+typedef struct sch_strtab
+{
+    struct
+    {
+        size_t size;
+        size_t capacity;
+        char *data;
+    } bytes;
+    struct
+    {
+        size_t size;
+        size_t capacity;
+        size_t *data;
+    } offsets;
+} strtab_t;
+
+// Functions =================================================
+
+/// Initializes a strtab_t struct.
+/// @param tab The table to initialize.
+/// @param capacity The number of strings to reserve room for. (must be greater than 0)
+void strtabnew(strtab_t *tab, size_t capacity);
+
+/// Frees the memory used by a strtab_t struct.
+/// @param tab The table to free.
+void strtabfree(strtab_t *tab);
+
+/// Returns the number of strings in a strtab_t struct.
+/// @param tab The table.
+/// @return The number of strings.
+size_t strtabsiz(const strtab_t *tab);
+
+/// Returns the number of bytes used by the strings of a strtab_t struct, including their NUL terminators.
+/// @param tab The table.
+/// @return The number of bytes used.
+size_t strtabbytes(const strtab_t *tab);
+
+/// Appends a C string to a strtab_t struct.
+/// @param tab The table to append to.
+/// @param cstr The C string to append.
+void strtabpush(strtab_t *tab, const char *cstr);
+
+/// Appends a range of bytes as a string to a strtab_t struct.
+/// @param tab The table to append to.
+/// @param data The bytes to append. (can be NULL if len is 0)
+/// @param len The number of bytes to append.
+void strtabpushn(strtab_t *tab, const char *data, size_t len);
+
+/// Appends a string_t struct to a strtab_t struct.
+/// @param tab The table to append to.
+/// @param str The string to append.
+void strtabpushd(strtab_t *tab, const string_t *str);
+
+/// Appends many C strings to a strtab_t struct, growing it at most once.
+/// @param tab The table to append to.
+/// @param cstrs The C strings to append.
+/// @param n The number of C strings.
+void strtabcat(strtab_t *tab, const char *const *cstrs, size_t n);
+
+/// Returns a string of a strtab_t struct.
+/// @param tab The table.
+/// @param index The index of the string.
+/// @param optional_len Receives the length of the string, or NULL.
+/// @return A pointer to the NUL-terminated string.
+const char *strtabget(const strtab_t *tab, size_t index, size_t *optional_len);
+
+/// Returns the length of a string of a strtab_t struct.
+/// @param tab The table.
+/// @param index The index of the string.
+/// @return The length of the string.
+size_t strtablen(const strtab_t *tab, size_t index);
+
+/// Copies a string of a strtab_t struct into a string_t struct.
+/// @param tab The table.
+/// @param index The index of the string.
+/// @param str The string to copy to. (must be initialized)
+void strtabdstr(const strtab_t *tab, size_t index, string_t *str);
+
+/// Computes the permutation that sorts a strtab_t struct by value (bytewise, like strcmp). The table itself is not modified.
+/// The sort is stable, so equal strings keep their relative order.
+/// @param tab The table.
+/// @param perm Receives strtabsiz(tab) indices, in sorted order.
+/// @return 1 on success, 0 if the scratch memory could not be allocated. (perm is left untouched)
+int strtabsort(const strtab_t *tab, size_t *perm);
+
+/// Removes every string from a strtab_t struct.
+/// @param tab The table to clear.
+void strtabclr(strtab_t *tab);
+
+SCH_API_END // End extern "C" block
+
+#endif // SCH_STRTAB_H
+
+#if defined(SCH_IMPL) && !defined(SCH_STRTAB_IMPL)
+#define SCH_STRTAB_IMPL
+
+// Implementation =============================================
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/// Make room for extra_bytes more bytes and extra_strings more strings, growing by at least 2x.
+static void sch_strtab_reserve(strtab_t *tab, size_t extra_bytes, size_t extra_strings)
+{
+    size_t bytes = tab->bytes.size + extra_bytes;
+    size_t offsets = tab->offsets.size + extra_strings;
+
+    if (bytes > tab->bytes.capacity)
+    {
+        darres(&tab->bytes, bytes > tab->bytes.capacity * 2 ? bytes : tab->bytes.capacity * 2);
+    }
+    if (offsets > tab->offsets.capacity)
+    {
+        darres(&tab->offsets, offsets > tab->offsets.capacity * 2 ? offsets : tab->offsets.capacity * 2);
+    }
+}
+
+/// Copy a string to the end of the buffer and record the offset that ends it. Room must already be reserved.
+inline static void sch_strtab_append(strtab_t *tab, const char *data, size_t len)
+{
+    memcpy(tab->bytes.data + tab->bytes.size, data, len);
+    tab->bytes.data[tab->bytes.size + len] = '\0';
+    tab->bytes.size += len + 1;
+    tab->offsets.data[tab->offsets.size++] = tab->bytes.size;
+}
+
+void strtabnew(strtab_t *tab, size_t capacity)
+{
+    size_t zero = 0;
+
+    assert(tab);
+    assert(capacity > 0);
+
+    darnew(&tab->bytes, capacity * 16);
+    darnew(&tab->offsets, capacity + 1);
+    darpush(&tab->offsets, zero);
+}
+
+void strtabfree(strtab_t *tab)
+{
+    assert(tab);
+
+    darfree(&tab->bytes);
+    darfree(&tab->offsets);
+}
+
+size_t strtabsiz(const strtab_t *tab)
+{
+    assert(tab);
+
+    return tab->offsets.size - 1;
+}
+
+size_t strtabbytes(const strtab_t *tab)
+{
+    assert(tab);
+
+    return tab->bytes.size;
+}
+
+void strtabpush(strtab_t *tab, const char *cstr)
+{
+    assert(tab);
+    assert(cstr);
+
+    strtabpushn(tab, cstr, strlen(cstr));
+}
+
+void strtabpushn(strtab_t *tab, const char *data, size_t len)
+{
+    assert(tab);
+    assert(data || len == 0);
+    assert(data == NULL || memchr(data, '\0', len) == NULL);
+
+    sch_strtab_reserve(tab, len + 1, 1);
+    sch_strtab_append(tab, len > 0 ? data : "", len);
+}
+
+void strtabpushd(strtab_t *tab, const string_t *str)
+{
+    assert(tab);
+    assert(str);
+
+    strtabpushn(tab, dstrc(str), dstrlen(str));
+}
+
+void strtabcat(strtab_t *tab, const char *const *cstrs, size_t n)
+{
+    size_t total = 0;
+    size_t *lens;
+    size_t i;
+
+    assert(tab);
+    assert(cstrs || n == 0);
+
+    if (n == 0)
+    {
+        return;
+    }
+
+    // Measure everything first so the buffer grows only once, stashing the lengths in the offsets we are about to fill.
+    sch_strtab_reserve(tab, 0, n);
+    lens = tab->offsets.data + tab->offsets.size;
+    for (i = 0; i < n; i++)
+    {
+        assert(cstrs[i]);
+        lens[i] = strlen(cstrs[i]);
+        total += lens[i] + 1;
+    }
+
+    sch_strtab_reserve(tab, total, 0);
+    for (i = 0; i < n; i++)
+    {
+        sch_strtab_append(tab, cstrs[i], lens[i]);
+    }
+}
+
+const char *strtabget(const strtab_t *tab, size_t index, size_t *optional_len)
+{
+    assert(tab);
+    assert(index < strtabsiz(tab));
+
+    if (optional_len)
+    {
+        *optional_len = tab->offsets.data[index + 1] - tab->offsets.data[index] - 1;
+    }
+
+    return tab->bytes.data + tab->offsets.data[index];
+}
+
+size_t strtablen(const strtab_t *tab, size_t index)
+{
+    assert(tab);
+    assert(index < strtabsiz(tab));
+
+    return tab->offsets.data[index + 1] - tab->offsets.data[index] - 1;
+}
+
+void strtabdstr(const strtab_t *tab, size_t index, string_t *str)
+{
+    assert(tab);
+    assert(str);
+
+    dstrcpy(str, strtabget(tab, index, NULL));
+}
+
+struct sch_strtab_key
+{
+    uint64_t prefix; // the first 8 bytes, big-endian, so integer order matches bytewise order
+    size_t index;
+};
+
+inline static uint64_t sch_strtab_prefix(const char *s, size_t len)
+{
+    uint64_t prefix = 0;
+    size_t i;
+
+    for (i = 0; i < 8; i++)
+    {
+        prefix = (prefix << 8) | (i < len ? (unsigned char)s[i] : 0);
+    }
+    return prefix;
+}
+
+inline static int sch_strtab_less(const strtab_t *tab, const struct sch_strtab_key *a, const struct sch_strtab_key *b)
+{
+    const char *sa, *sb;
+    size_t la, lb;
+    int c;
+
+    if (a->prefix != b->prefix)
+    {
+        return a->prefix < b->prefix;
+    }
+
+    // Equal prefixes: compare the rest, the NUL terminators make a shorter string sort first.
+    sa = strtabget(tab, a->index, &la);
+    sb = strtabget(tab, b->index, &lb);
+    if (la <= 8 || lb <= 8)
+    {
+        return la < lb;
+    }
+    c = memcmp(sa + 8, sb + 8, (la < lb ? la : lb) - 8);
+    return c < 0 || (c == 0 && la < lb);
+}
+
+int strtabsort(const strtab_t *tab, size_t *perm)
+{
+    struct sch_strtab_key *keys, *tmp, *src, *dst;
+    size_t n, width, i;
+
+    assert(tab);
+
+    n = strtabsiz(tab);
+    if (n == 0)
+    {
+        return 1;
+    }
+    assert(perm);
+
+    // Bottom-up merge sort over (prefix, index) pairs: most comparisons are settled by the
+    // prefix without touching the string bytes, and the keys are scanned sequentially.
+    keys = (struct sch_strtab_key *)malloc(n * 2 * sizeof(*keys));
+    if (keys == NULL)
+    {
+        return 0;
+    }
+    tmp = keys + n;
+    for (i = 0; i < n; i++)
+    {
+        size_t len;
+        const char *s = strtabget(tab, i, &len);
+        keys[i].prefix = sch_strtab_prefix(s, len);
+        keys[i].index = i;
+    }
+
+    src = keys;
+    dst = tmp;
+    for (width = 1; width < n; width *= 2)
+    {
+        for (i = 0; i < n; i += 2 * width)
+        {
+            size_t mid = i + width < n ? i + width : n;
+            size_t end = i + 2 * width < n ? i + 2 * width : n;
+            size_t l = i, r = mid, k = i;
+            while (l < mid && r < end)
+            {
+                dst[k++] = sch_strtab_less(tab, &src[r], &src[l]) ? src[r++] : src[l++];
+            }
+            while (l < mid)
+            {
+                dst[k++] = src[l++];
+            }
+            while (r < end)
+            {
+                dst[k++] = src[r++];
+            }
+        }
+        src = dst;
+        dst = src == keys ? tmp : keys;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        perm[i] = src[i].index;
+    }
+    free(keys);
+    return 1;
+}
+
+void strtabclr(strtab_t *tab)
+{
+    assert(tab);
+
+    darclr(&tab->bytes);
+    tab->offsets.size = 1;
+}
+
+#endif // SCH_IMPL && !SCH_STRTAB_IMPL
@@ -1,3 +1,12 @@
+#define _GNU_SOURCE // lets sch_array.h back SCH_DAR_HUGEPAGES arrays with mmap and mremap
 #define SCH_IMPL
 #include "sch_array.h"
-#include "sch_string.h"
\ No newline at end of file
+#include "sch_string.h"
+#include "sch_strconv.h"
+#include "sch_strescape.h"
+#include "sch_strcodec.h"
+#include "sch_slotmap.h"
+#include "sch_pqueue.h"
+#include "sch_strtab.h"
+#include "sch_recycle.h"
+#include "sch_stridx.h"
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include <stdio.h>
 #include "sch_array.h"
 #include "sch_string.h"
+#include "test.h"
+
+int sch_test_failures = 0;
 
 int main(void)
 {
@@ -27,5 +30,22 @@ int main(void)
 
     dstrfree(&str);
 
+    test_array();
+    test_string();
+    test_strconv();
+    test_strescape();
+    test_strcodec();
+    test_slotmap();
+    test_pqueue();
+    test_strtab();
+    test_recycle();
+    test_stridx();
+
+    if (sch_test_failures > 0)
+    {
+        printf("%d checks failed\n", sch_test_failures);
+        return 1;
+    }
+    printf("All checks passed\n");
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef SCH_TEST_H
+#define SCH_TEST_H
+
+#include <stdio.h>
+
+// Each test_* function checks one header and records failed checks in sch_test_failures.
+extern int sch_test_failures;
+
+#define CHECK(cond)                                                                   \
+    do                                                                                \
+    {                                                                                 \
+        if (!(cond))                                                                  \
+        {                                                                             \
+            sch_test_failures++;                                                      \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);  \
+        }                                                                             \
+    } while (0)
+
+void test_array(void);
+void test_string(void);
+void test_strconv(void);
+void test_strescape(void);
+void test_strcodec(void);
+void test_slotmap(void);
+void test_pqueue(void);
+void test_strtab(void);
+void test_recycle(void);
+void test_stridx(void);
+
+#endif // SCH_TEST_H
@@ -0,0 +1,73 @@
+#include <stdint.h>
+#include "sch_array.h"
+#include "test.h"
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    double *data;
+} double_array;
+
+static int is_aligned(const void *p, size_t alignment)
+{
+    return ((uintptr_t)p & (alignment - 1)) == 0;
+}
+
+static int has_values(const double_array *arr, size_t n)
+{
+    size_t i;
+    for (i = 0; i < n; i++)
+    {
+        if (arr->data[i] != (double)i)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/// The alignment given to darnewx must hold after growth by darpush, darres and darfit.
+static void check_alignment(size_t alignment, unsigned flags, size_t count)
+{
+    double_array arr;
+    size_t i;
+    int aligned = 1;
+
+    darnewx(&arr, 1, alignment, flags);
+    CHECK(daralign(&arr) == alignment);
+    CHECK(is_aligned(arr.data, alignment));
+
+    for (i = 0; i < count; i++)
+    {
+        double value = (double)i;
+        darpush(&arr, value);
+        aligned &= is_aligned(arr.data, alignment);
+    }
+    CHECK(aligned);
+    CHECK(has_values(&arr, count));
+
+    darres(&arr, count * 3);
+    CHECK(darcap(&arr) == count * 3);
+    CHECK(is_aligned(arr.data, alignment));
+    CHECK(has_values(&arr, count));
+
+    darfit(&arr);
+    CHECK(darcap(&arr) == count);
+    CHECK(daralign(&arr) == alignment);
+    CHECK(is_aligned(arr.data, alignment));
+    CHECK(has_values(&arr, count));
+
+    darfree(&arr);
+    CHECK(arr.data == NULL);
+}
+
+void test_array(void)
+{
+    check_alignment(64, 0, 10000);
+    check_alignment(4096, 0, 10000);
+
+    // Past SCH_DAR_HUGEPAGE_THRESHOLD, so the mmap path is taken where it exists.
+    check_alignment(64, SCH_DAR_HUGEPAGES, (SCH_DAR_HUGEPAGE_THRESHOLD / sizeof(double)) * 2);
+    check_alignment(4096, SCH_DAR_HUGEPAGES, (SCH_DAR_HUGEPAGE_THRESHOLD / sizeof(double)) * 2);
+}
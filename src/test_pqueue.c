@@ -0,0 +1,270 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sch_pqueue.h"
+#include "test.h"
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    int *data;
+} int_array;
+
+typedef struct
+{
+    int key;
+    size_t id;
+} task;
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    task *data;
+    struct sch_pq_index index;
+} task_queue;
+
+#define ELEMENTS 2000
+#define IDS 300
+#define OPERATIONS 20000
+
+static int int_cmp(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static int task_cmp(const void *a, const void *b)
+{
+    const task *x = a, *y = b;
+    return (x->key > y->key) - (x->key < y->key);
+}
+
+static uint64_t next_rand(uint64_t *rng)
+{
+    *rng = *rng * 6364136223846793005ull + 1442695040888963407ull;
+    return *rng >> 33;
+}
+
+/// Popping everything gives the values in ascending order, the same as qsort.
+static int pops_sorted(int_array *heap)
+{
+    int *want = malloc((heap->size + 1) * sizeof(int));
+    size_t n = heap->size, i;
+    int ok = 1;
+
+    memcpy(want, heap->data, n * sizeof(int));
+    qsort(want, n, sizeof(int), int_cmp);
+    for (i = 0; i < n; i++)
+    {
+        int value;
+        ok &= *pqtop(heap) == want[i];
+        pqpop(heap, &value, int_cmp);
+        ok &= value == want[i];
+    }
+    ok &= heap->size == 0 && pqtop(heap) == NULL;
+
+    free(want);
+    return ok;
+}
+
+static void check_heap(void)
+{
+    int_array heap;
+    uint64_t rng = 21;
+    size_t i;
+
+    // Random pushes, with many duplicates.
+    darnew(&heap, 1);
+    for (i = 0; i < ELEMENTS; i++)
+    {
+        int value = (int)(next_rand(&rng) % 500);
+        pqpush(&heap, value, int_cmp);
+    }
+    CHECK(pops_sorted(&heap));
+
+    // Pushing an element of the heap itself, while the push also grows the heap.
+    for (i = 0; i < ELEMENTS; i++)
+    {
+        int value = (int)(next_rand(&rng) % 500);
+        if (heap.size > 0 && i % 3 == 0)
+        {
+            pqpush(&heap, heap.data[heap.size - 1], int_cmp);
+            pqpush(&heap, heap.data[0], int_cmp);
+        }
+        else
+        {
+            pqpush(&heap, value, int_cmp);
+        }
+    }
+    CHECK(pops_sorted(&heap));
+
+    // pqify on every size from 0 up, since the last parent depends on the size.
+    for (i = 0; i < 100; i++)
+    {
+        size_t j;
+        darclr(&heap);
+        for (j = 0; j < i; j++)
+        {
+            int value = (int)(next_rand(&rng) % 50) - 25;
+            darpush(&heap, value);
+        }
+        pqify(&heap, int_cmp);
+        CHECK(pops_sorted(&heap));
+    }
+
+    darfree(&heap);
+}
+
+/// Every element sits no earlier than its parent, and the index maps each id to its position and back.
+static int ipq_consistent(const task_queue *q, const int *keys, const int *present)
+{
+    size_t i, count = 0;
+    int ok = 1;
+
+    for (i = 1; i < q->size; i++)
+    {
+        ok &= q->data[(i - 1) / SCH_PQ_ARITY].key <= q->data[i].key;
+    }
+    for (i = 0; i < q->size; i++)
+    {
+        ok &= ipqpos(q, q->data[i].id) == i && q->index.ids.data[i] == q->data[i].id;
+    }
+    for (i = 0; i < IDS; i++)
+    {
+        size_t pos = ipqpos(q, i);
+        if (present[i])
+        {
+            count++;
+            ok &= pos < q->size && q->data[pos].id == i && q->data[pos].key == keys[i];
+        }
+        else
+        {
+            ok &= pos == SCH_PQ_NONE;
+        }
+    }
+    ok &= count == q->size;
+    return ok;
+}
+
+/// The id holding the smallest key. Keys are unique, so it is the only one ipqpop may return.
+static size_t ref_min(const int *keys, const int *present)
+{
+    size_t i, best = SCH_PQ_NONE;
+    for (i = 0; i < IDS; i++)
+    {
+        if (present[i] && (best == SCH_PQ_NONE || keys[i] < keys[best]))
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+static void check_indexed(void)
+{
+    static int keys[IDS], present[IDS];
+    task_queue q;
+    uint64_t rng = 22;
+    size_t i, decreases = 0, increases = 0;
+    int ok = 1;
+
+    ipqnew(&q, 1);
+    for (i = 0; i < OPERATIONS; i++)
+    {
+        size_t id = (size_t)(next_rand(&rng) % IDS);
+        // Keys are unique: the random part is scaled by IDS and the id breaks ties.
+        task t;
+        t.key = (int)(next_rand(&rng) % 1000) * IDS + (int)id;
+        t.id = id;
+
+        switch (next_rand(&rng) % 4)
+        {
+        case 0:
+            if (!present[id])
+            {
+                ipqpush(&q, t, id, task_cmp);
+                keys[id] = t.key;
+                present[id] = 1;
+            }
+            break;
+        case 1:
+            if (present[id])
+            {
+                // Alternate between decrease-key and increase-key, keeping the key unique.
+                int step = (int)(next_rand(&rng) % 50 + 1) * IDS;
+                t.key = i % 2 == 0 ? keys[id] - step : keys[id] + step;
+                decreases += t.key < keys[id];
+                increases += t.key > keys[id];
+                ipqupd(&q, t, id, task_cmp);
+                keys[id] = t.key;
+            }
+            break;
+        case 2:
+        {
+            task out;
+            out.key = -1;
+            ok &= ipqrem(&q, id, &out, task_cmp) == present[id];
+            ok &= !present[id] || (out.key == keys[id] && out.id == id);
+            present[id] = 0;
+            break;
+        }
+        default:
+            if (q.size > 0)
+            {
+                size_t want = ref_min(keys, present);
+                task out;
+                ok &= ipqtop(&q)->id == want;
+                ok &= ipqpop(&q, &out, task_cmp) == want && out.id == want && out.key == keys[want];
+                present[want] = 0;
+            }
+            break;
+        }
+        ok &= ipq_consistent(&q, keys, present);
+    }
+    CHECK(ok);
+    CHECK(decreases > 50 && increases > 50);
+
+    // Drain in order.
+    ok = 1;
+    while (q.size > 0)
+    {
+        size_t want = ref_min(keys, present);
+        ok &= ipqpop(&q, NULL, task_cmp) == want;
+        present[want] = 0;
+        ok &= ipq_consistent(&q, keys, present);
+    }
+    CHECK(ok);
+
+    // Pushing an element of the queue itself under a new id.
+    for (i = 0; i < IDS / 2; i++)
+    {
+        task t;
+        t.key = (int)i;
+        t.id = i;
+        ipqpush(&q, t, i, task_cmp);
+        keys[i] = t.key;
+        present[i] = 1;
+    }
+    for (i = IDS / 2; i < IDS; i++)
+    {
+        ipqpush(&q, q.data[q.size - 1], i, task_cmp);
+        keys[i] = q.data[ipqpos(&q, i)].key;
+        q.data[ipqpos(&q, i)].id = i;
+        present[i] = 1;
+    }
+    CHECK(q.size == IDS);
+    CHECK(ipq_consistent(&q, keys, present));
+
+    ipqclr(&q);
+    CHECK(q.size == 0 && ipqtop(&q) == NULL && ipqpos(&q, 0) == SCH_PQ_NONE && ipqrem(&q, 0, NULL, task_cmp) == 0);
+
+    ipqfree(&q);
+}
+
+void test_pqueue(void)
+{
+    check_heap();
+    check_indexed();
+}
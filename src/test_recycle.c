@@ -0,0 +1,106 @@
+#include <stdint.h>
+#include <string.h>
+#include "sch_recycle.h"
+#include "test.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+# include <pthread.h>
+# define TEST_THREADS
+#endif // POSIX
+
+#define LIVE 32
+
+static const size_t churn_sizes[] = {24, 100, 500, 3000, 40000};
+
+/// Allocate and free LIVE buffers of every size in churn_sizes, touching each one.
+static void churn_once(void)
+{
+    void *live[LIVE];
+    size_t s, i;
+
+    for (s = 0; s < sizeof(churn_sizes) / sizeof(churn_sizes[0]); s++)
+    {
+        for (i = 0; i < LIVE; i++)
+        {
+            live[i] = sch_recycle_alloc(churn_sizes[s]);
+            memset(live[i], (int)i, churn_sizes[s]);
+        }
+        for (i = 0; i < LIVE; i++)
+        {
+            live[i] = sch_recycle_realloc(live[i], churn_sizes[s], churn_sizes[s] + 1);
+        }
+        for (i = 0; i < LIVE; i++)
+        {
+            sch_recycle_free(live[i], churn_sizes[s] + 1);
+        }
+    }
+}
+
+#ifdef TEST_THREADS
+
+/// Leaves buffers cached on exit. The thread-exit destructor must free them (LeakSanitizer reports them otherwise).
+static void *churn_thread(void *arg)
+{
+    struct sch_recycle_stats stats;
+    (void)arg;
+    churn_once();
+    sch_recycle_stats(&stats);
+    return (void *)(uintptr_t)(stats.cached_blocks > 0);
+}
+
+#endif // TEST_THREADS
+
+void test_recycle(void)
+{
+    struct sch_recycle_stats before, after;
+    void *p;
+    int i;
+
+    CHECK(sch_recycle_usable(1) == 16);
+    CHECK(sch_recycle_usable(17) == 32);
+    CHECK(sch_recycle_usable(3000) == 4096);
+    CHECK(sch_recycle_usable(((size_t)1 << SCH_RECYCLE_MAX_SHIFT) + 1) == ((size_t)1 << SCH_RECYCLE_MAX_SHIFT) + 1);
+
+    // Once warmed up, churning through the same sizes must never call malloc again.
+    churn_once();
+    sch_recycle_stats(&before);
+    for (i = 0; i < 1000; i++)
+    {
+        churn_once();
+    }
+    sch_recycle_stats(&after);
+    CHECK(after.misses == before.misses);
+    CHECK(after.hits > before.hits);
+    CHECK(after.released == before.released);
+    CHECK(after.cached_blocks == before.cached_blocks);
+
+    // Growing within a class keeps the buffer.
+    p = sch_recycle_alloc(40);
+    CHECK(sch_recycle_realloc(p, 40, 60) == p);
+    sch_recycle_free(p, 60);
+
+    // A class with a cap of 0 is not recycled.
+    sch_recycle_setcap(200000, 0);
+    p = sch_recycle_alloc(200000);
+    sch_recycle_stats(&before);
+    sch_recycle_free(p, 200000);
+    sch_recycle_stats(&after);
+    CHECK(after.released == before.released + 1);
+    CHECK(after.cached_blocks == before.cached_blocks);
+    sch_recycle_setcap(200000, SCH_RECYCLE_DEFAULT_CAP);
+
+    sch_recycle_trim();
+    sch_recycle_stats(&after);
+    CHECK(after.cached_blocks == 0);
+    CHECK(after.cached_bytes == 0);
+
+#ifdef TEST_THREADS
+    {
+        pthread_t thread;
+        void *cached = NULL;
+        CHECK(pthread_create(&thread, NULL, churn_thread, NULL) == 0);
+        CHECK(pthread_join(thread, &cached) == 0);
+        CHECK(cached != NULL);
+    }
+#endif // TEST_THREADS
+}
@@ -0,0 +1,145 @@
+#include <stdint.h>
+#include "sch_slotmap.h"
+#include "test.h"
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    int *data;
+    struct sch_slotmap_index index;
+} int_map;
+
+#define OPERATIONS 5000
+#define MAX_HANDLES OPERATIONS
+
+/// Every handle ever returned, with the value it was inserted with and whether it has been removed since.
+typedef struct
+{
+    sch_handle handle;
+    int value;
+    int live;
+} ref_entry;
+
+/// The map agrees with the reference: live handles find their values, removed ones are rejected,
+/// and every packed value's handle points back at it.
+static int agrees(const int_map *map, const ref_entry *ref, size_t n)
+{
+    size_t i, live = 0;
+    int ok = 1;
+
+    for (i = 0; i < n; i++)
+    {
+        const int *value = (const int *)slmget(map, ref[i].handle);
+        if (ref[i].live)
+        {
+            live++;
+            ok &= slmhas(map, ref[i].handle) && value != NULL && *value == ref[i].value;
+            ok &= slmidx(map, ref[i].handle) < slmsiz(map) && value == &map->data[slmidx(map, ref[i].handle)];
+        }
+        else
+        {
+            ok &= !slmhas(map, ref[i].handle) && value == NULL && slmidx(map, ref[i].handle) == (size_t)-1;
+        }
+    }
+    ok &= slmsiz(map) == live;
+
+    for (i = 0; i < slmsiz(map); i++)
+    {
+        ok &= slmidx(map, slmhdl(map, i)) == i;
+    }
+    return ok;
+}
+
+/// Random inserts and removes, checked against the reference after each one.
+static void check_random(void)
+{
+    static ref_entry ref[MAX_HANDLES];
+    int_map map;
+    uint64_t rng = 11;
+    size_t n = 0, i;
+    int ok = 1;
+
+    slmnew(&map, 1);
+    for (i = 0; i < OPERATIONS; i++)
+    {
+        rng = rng * 6364136223846793005ull + 1442695040888963407ull;
+        if (n == 0 || (rng >> 33) % 5 < 3)
+        {
+            int value = (int)i;
+            ref[n].handle = slmins(&map, value);
+            ref[n].value = value;
+            ref[n].live = 1;
+            n++;
+        }
+        else
+        {
+            // Removing a handle twice, or an already removed one, must be rejected and change nothing.
+            size_t victim = (size_t)(rng >> 40) % n;
+            ok &= slmrem(&map, ref[victim].handle) == ref[victim].live;
+            ref[victim].live = 0;
+        }
+        ok &= agrees(&map, ref, n);
+    }
+    CHECK(ok);
+
+    // Clearing makes every handle stale, and the slots are reused with new generations.
+    slmclr(&map);
+    for (i = 0; i < n; i++)
+    {
+        ref[i].live = 0;
+    }
+    CHECK(slmsiz(&map) == 0);
+    CHECK(agrees(&map, ref, n));
+    for (i = 0; i < 100; i++)
+    {
+        int value = -(int)i;
+        ref[n].handle = slmins(&map, value);
+        ref[n].value = value;
+        ref[n].live = 1;
+        n++;
+    }
+    CHECK(agrees(&map, ref, n));
+
+    slmfree(&map);
+}
+
+static void check_reuse(void)
+{
+    int_map map;
+    int a = 1, b = 2, c = 3, d = 4;
+    sch_handle ha, hb, hc, hd;
+
+    slmnew(&map, 4);
+    CHECK(!slmhas(&map, SCH_NULL_HANDLE) && slmget(&map, SCH_NULL_HANDLE) == NULL);
+
+    ha = slmins(&map, a);
+    hb = slmins(&map, b);
+    hc = slmins(&map, c);
+    CHECK(ha != SCH_NULL_HANDLE && hb != SCH_NULL_HANDLE && hc != SCH_NULL_HANDLE);
+    CHECK(!slmhas(&map, SCH_NULL_HANDLE) && slmrem(&map, SCH_NULL_HANDLE) == 0);
+
+    // Removing the first value moves the last one into its place.
+    CHECK(slmrem(&map, ha) == 1);
+    CHECK(slmsiz(&map) == 2 && map.data[0] == 3 && map.data[1] == 2);
+    CHECK(slmidx(&map, hc) == 0 && slmhdl(&map, 0) == hc);
+    CHECK(slmidx(&map, hb) == 1 && slmhdl(&map, 1) == hb);
+
+    // The freed slot is reused, but the old handle stays stale.
+    hd = slmins(&map, d);
+    CHECK((uint32_t)hd == (uint32_t)ha && hd != ha);
+    CHECK(!slmhas(&map, ha) && slmget(&map, ha) == NULL && slmrem(&map, ha) == 0);
+    CHECK(*(int *)slmget(&map, hd) == 4);
+    CHECK(slmsiz(&map) == 3);
+
+    // Handles to slots that were never allocated are rejected too.
+    CHECK(!slmhas(&map, hc + 1000) && slmget(&map, ((sch_handle)1 << 32) | 1000) == NULL);
+
+    slmfree(&map);
+}
+
+void test_slotmap(void)
+{
+    check_reuse();
+    check_random();
+}
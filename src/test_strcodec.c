@@ -0,0 +1,255 @@
+#include <stdint.h>
+#include <string.h>
+#include "sch_strcodec.h"
+#include "test.h"
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    unsigned char *data;
+} byte_array;
+
+// Every length from 0 to MAX_BYTES is tried, which crosses each kernel's block size
+// (16 and 32 bytes in for hex, 12 and 24 for base64, 32 and 64 characters out) several times over.
+#define MAX_BYTES 100
+
+static const char *isa_names[] = {"scalar", "ssse3", "avx2"};
+
+// The scalar reference the kernels are checked against.
+
+static size_t ref_hex(char *out, const unsigned char *in, size_t len, int upper)
+{
+    const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    size_t i;
+    for (i = 0; i < len; i++)
+    {
+        out[i * 2] = digits[in[i] >> 4];
+        out[i * 2 + 1] = digits[in[i] & 15];
+    }
+    out[len * 2] = '\0';
+    return len * 2;
+}
+
+static size_t ref_base64(char *out, const unsigned char *in, size_t len)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t i, o = 0;
+    for (i = 0; i < len; i += 3)
+    {
+        uint32_t group = (uint32_t)in[i] << 16;
+        if (i + 1 < len)
+        {
+            group |= (uint32_t)in[i + 1] << 8;
+        }
+        if (i + 2 < len)
+        {
+            group |= in[i + 2];
+        }
+        out[o++] = alphabet[group >> 18];
+        out[o++] = alphabet[(group >> 12) & 63];
+        out[o++] = i + 1 < len ? alphabet[(group >> 6) & 63] : '=';
+        out[o++] = i + 2 < len ? alphabet[group & 63] : '=';
+    }
+    out[o] = '\0';
+    return o;
+}
+
+static void fill_random(unsigned char *bytes, size_t len, uint64_t *rng)
+{
+    size_t i;
+    for (i = 0; i < len; i++)
+    {
+        *rng = *rng * 6364136223846793005ull + 1442695040888963407ull;
+        bytes[i] = (unsigned char)(*rng >> 56);
+    }
+}
+
+/// The array holds a marker byte followed by want.
+static int holds(const byte_array *arr, const unsigned char *want, size_t len)
+{
+    return arr->size == len + 1 && arr->data[0] == 0xA5 && memcmp(arr->data + 1, want, len) == 0;
+}
+
+static int decodes_to(int (*decode)(const string_t *, struct sch_dar *), const char *text, size_t text_len,
+                      const unsigned char *want, size_t len)
+{
+    string_t str;
+    byte_array arr;
+    unsigned char marker = 0xA5;
+    int ok;
+
+    dstrnew(&str, "");
+    dstrcatn(&str, text, text_len);
+    darnew(&arr, 1);
+    darpush(&arr, marker);
+
+    ok = decode(&str, sch_to_dar(&arr)) == 1 && holds(&arr, want, len);
+
+    darfree(&arr);
+    dstrfree(&str);
+    return ok;
+}
+
+/// A corrupted input must be rejected and leave the array as it was.
+static int rejects(int (*decode)(const string_t *, struct sch_dar *), const char *text, size_t text_len)
+{
+    string_t str;
+    byte_array arr;
+    unsigned char marker = 0xA5;
+    int ok;
+
+    dstrnew(&str, "");
+    dstrcatn(&str, text, text_len);
+    darnew(&arr, 1);
+    darpush(&arr, marker);
+
+    ok = decode(&str, sch_to_dar(&arr)) == 0 && holds(&arr, (const unsigned char *)"", 0);
+
+    darfree(&arr);
+    dstrfree(&str);
+    return ok;
+}
+
+static int encodes_to(void (*encode)(string_t *, const void *, size_t), const unsigned char *bytes, size_t len,
+                      const char *want)
+{
+    string_t str;
+    int ok;
+
+    dstrnew(&str, "prefix:");
+    encode(&str, bytes, len);
+    ok = strncmp(dstrc(&str), "prefix:", 7) == 0 && strcmp(dstrc(&str) + 7, want) == 0 &&
+         dstrlen(&str) == 7 + strlen(want);
+    dstrfree(&str);
+    return ok;
+}
+
+/// Encoding the string's own contents, which the encoder's growth moves, gives the same text as a copy would.
+/// The string holds "ab", then the bytes, and only the bytes are encoded.
+static int encodes_itself(void (*encode)(string_t *, const void *, size_t), const unsigned char *bytes, size_t len,
+                          const char *want)
+{
+    string_t str;
+    int ok;
+
+    dstrnew(&str, "ab");
+    dstrcatn(&str, (const char *)bytes, len);
+    encode(&str, dstrc(&str) + 2, len);
+    ok = dstrlen(&str) == 2 + len + strlen(want) && memcmp(dstrc(&str) + 2, bytes, len) == 0 &&
+         strcmp(dstrc(&str) + 2 + len, want) == 0;
+    dstrfree(&str);
+    return ok;
+}
+
+static void check_hex(int isa)
+{
+    static const char bad[] = "g/:@G`\x80 ";
+    unsigned char bytes[MAX_BYTES];
+    char text[MAX_BYTES * 2 + 1];
+    uint64_t rng = 1;
+    size_t len, pos;
+    int failures = sch_test_failures;
+
+    for (len = 0; len <= MAX_BYTES; len++)
+    {
+        size_t text_len;
+        fill_random(bytes, len, &rng);
+
+        text_len = ref_hex(text, bytes, len, 0);
+        CHECK(encodes_to(dstrcathex, bytes, len, text));
+        CHECK(encodes_itself(dstrcathex, bytes, len, text));
+        CHECK(decodes_to(dstrdechex, text, text_len, bytes, len));
+
+        for (pos = 0; pos < text_len; pos++)
+        {
+            char saved = text[pos];
+            text[pos] = bad[(len + pos) % (sizeof(bad) - 1)];
+            CHECK(rejects(dstrdechex, text, text_len));
+            text[pos] = saved;
+        }
+        if (len > 0)
+        {
+            CHECK(rejects(dstrdechex, text, text_len - 1));
+        }
+
+        ref_hex(text, bytes, len, 1);
+        CHECK(decodes_to(dstrdechex, text, text_len, bytes, len));
+    }
+
+    if (sch_test_failures != failures)
+    {
+        fprintf(stderr, "hex failed with the %s kernels\n", isa_names[isa]);
+    }
+}
+
+static void check_base64(int isa)
+{
+    static const char bad[] = "*-_=.\x80 \n";
+    unsigned char bytes[MAX_BYTES];
+    char text[(MAX_BYTES + 2) / 3 * 4 + 1];
+    uint64_t rng = 2;
+    size_t len, pos;
+    int failures = sch_test_failures;
+
+    for (len = 0; len <= MAX_BYTES; len++)
+    {
+        size_t text_len, unpadded;
+        fill_random(bytes, len, &rng);
+
+        text_len = ref_base64(text, bytes, len);
+        CHECK(encodes_to(dstrcatbase64, bytes, len, text));
+        CHECK(encodes_itself(dstrcatbase64, bytes, len, text));
+        CHECK(decodes_to(dstrdecbase64, text, text_len, bytes, len));
+
+        // Padding is optional.
+        unpadded = text_len;
+        while (unpadded > 0 && text[unpadded - 1] == '=')
+        {
+            unpadded--;
+        }
+        CHECK(decodes_to(dstrdecbase64, text, unpadded, bytes, len));
+
+        for (pos = 0; pos < unpadded; pos++)
+        {
+            char saved = text[pos];
+            text[pos] = bad[(len + pos) % (sizeof(bad) - 1)];
+            if (text[pos] == '=' && pos + 4 >= text_len)
+            {
+                text[pos] = '*'; // '=' here would just be earlier padding, which is valid
+            }
+            CHECK(rejects(dstrdecbase64, text, text_len));
+            text[pos] = saved;
+        }
+        if (unpadded % 4 == 0 && unpadded > 0)
+        {
+            // One character past a whole quantum can't encode a byte.
+            text[unpadded] = 'A';
+            CHECK(rejects(dstrdecbase64, text, unpadded + 1));
+            text[unpadded] = '\0';
+        }
+    }
+
+    CHECK(rejects(dstrdecbase64, "QQ==QUFB", 8));
+    CHECK(rejects(dstrdecbase64, "Q===", 4));
+    CHECK(rejects(dstrdecbase64, "QQ=", 3));
+    CHECK(rejects(dstrdecbase64, "=", 1));
+
+    if (sch_test_failures != failures)
+    {
+        fprintf(stderr, "base64 failed with the %s kernels\n", isa_names[isa]);
+    }
+}
+
+void test_strcodec(void)
+{
+    int isa;
+
+    for (isa = SCH_STRCODEC_SCALAR; isa <= SCH_STRCODEC_AVX2; isa++)
+    {
+        dstrcodecisa(isa);
+        check_hex(isa);
+        check_base64(isa);
+    }
+    dstrcodecisa(SCH_STRCODEC_AVX2);
+}
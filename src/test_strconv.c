@@ -0,0 +1,158 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "sch_strconv.h"
+#include "test.h"
+
+static size_t parse_i64(const char *text, int64_t *out)
+{
+    string_t str;
+    size_t used;
+    dstrnew(&str, text);
+    used = dstrtoi64(&str, out);
+    dstrfree(&str);
+    return used;
+}
+
+static size_t parse_u64(const char *text, uint64_t *out)
+{
+    string_t str;
+    size_t used;
+    dstrnew(&str, text);
+    used = dstrtou64(&str, out);
+    dstrfree(&str);
+    return used;
+}
+
+/// dstrtof64 must give the same bits and consume the same characters as strtod.
+static int same_as_strtod(const char *text)
+{
+    string_t str;
+    double got = -1.0;
+    char *end;
+    double want = strtod(text, &end);
+    size_t used;
+
+    dstrnew(&str, text);
+    used = dstrtof64(&str, &got);
+    dstrfree(&str);
+
+    if (used != (size_t)(end - text))
+    {
+        fprintf(stderr, "  \"%s\": consumed %zu, strtod consumed %zu\n", text, used, (size_t)(end - text));
+        return 0;
+    }
+    if (used == 0)
+    {
+        return 1;
+    }
+    if (isnan(want))
+    {
+        return isnan(got);
+    }
+    if (memcmp(&got, &want, sizeof(double)) != 0)
+    {
+        fprintf(stderr, "  \"%s\": got %.17g, strtod gave %.17g\n", text, got, want);
+        return 0;
+    }
+    return 1;
+}
+
+static void test_integers(void)
+{
+    int64_t i = 0;
+    uint64_t u = 0;
+    string_t str;
+
+    CHECK(parse_i64("9223372036854775807", &i) == 19 && i == INT64_MAX);
+    CHECK(parse_i64("-9223372036854775808", &i) == 20 && i == INT64_MIN);
+    i = 42;
+    CHECK(parse_i64("9223372036854775808", &i) == 0 && i == 42);
+    CHECK(parse_i64("-9223372036854775809", &i) == 0 && i == 42);
+    CHECK(parse_i64("99999999999999999999", &i) == 0 && i == 42);
+    CHECK(parse_i64("+17", &i) == 3 && i == 17);
+    CHECK(parse_i64("-0", &i) == 2 && i == 0);
+    CHECK(parse_i64("00000000000000000000000012", &i) == 26 && i == 12);
+    CHECK(parse_i64("123abc", &i) == 3 && i == 123);
+    CHECK(parse_i64("12345678x", &i) == 8 && i == 12345678);
+    i = 42;
+    CHECK(parse_i64("", &i) == 0 && i == 42);
+    CHECK(parse_i64("-", &i) == 0 && i == 42);
+    CHECK(parse_i64(" 1", &i) == 0 && i == 42);
+
+    CHECK(parse_u64("18446744073709551615", &u) == 20 && u == UINT64_MAX);
+    u = 42;
+    CHECK(parse_u64("18446744073709551616", &u) == 0 && u == 42);
+    CHECK(parse_u64("-1", &u) == 0 && u == 42);
+    CHECK(parse_u64("+1", &u) == 2 && u == 1);
+    CHECK(parse_u64("0", &u) == 1 && u == 0);
+
+    // Ranges are clamped to the string and do not need a NUL terminator after them.
+    dstrnew(&str, "x12345");
+    CHECK(dstrtoi64r(&str, 2, 2, &i) == 2 && i == 23);
+    CHECK(dstrtou64r(&str, 1, (size_t)-1, &u) == 5 && u == 12345);
+    i = 42;
+    CHECK(dstrtoi64r(&str, 100, 5, &i) == 0 && i == 42);
+    dstrfree(&str);
+}
+
+static void test_floats(void)
+{
+    static const char *const cases[] = {
+        "0", "-0.0", "1", "0.1", "1.5", ".5", "5.", "1e", "1e+", "1e-5x", "-", ".", "e5", "1.0E+2",
+        "inf", "-Infinity", "infinit", "nan", "NaN(123)", "nan()", "nan(1_x)z", "nan(1-2)", "nan(",
+        // halfway cases between adjacent doubles
+        "9007199254740993", "9007199254740995", "9007199254740992.5", "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203124", "1.00000000000000011102230246251565404236316680908203126",
+        // subnormals and range limits
+        "2.2250738585072011e-308", "2.2250738585072014e-308", "4.9406564584124654e-324", "2.4703282292062327e-324",
+        "2.4703282292062328e-324", "1e-320", "1e-400", "1.7976931348623157e308", "1.7976931348623158e308",
+        "1.797693134862315807e308", "1e309", "-1e309",
+        // more than 19 significant digits
+        "3.14159265358979323846264338327950288", "123456789012345678901234567890", "0.1000000000000000055511151231257827021181583404541015625",
+        "7.0385307e-26", "1e23", "8.98846567431158e307", "0.000000000000000000000000000000000000001",
+        "18446744073709551616", "18446744073709551615.5", "99999999999999999999999999999999999999999e-30",
+    };
+    size_t i;
+    uint64_t seed = 1;
+    char text[64];
+    int random_ok = 1;
+
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        CHECK(same_as_strtod(cases[i]));
+    }
+
+    // Random decimal strings with up to 25 digits and a wide exponent range.
+    for (i = 0; i < 200000; i++)
+    {
+        size_t len = 0, digits, d;
+        seed ^= seed >> 12;
+        seed ^= seed << 25;
+        seed ^= seed >> 27;
+        digits = 1 + (size_t)(seed % 25);
+        if (seed & 64)
+        {
+            text[len++] = '-';
+        }
+        for (d = 0; d < digits; d++)
+        {
+            seed = seed * UINT64_C(6364136223846793005) + 1;
+            text[len++] = (char)('0' + (seed >> 60) % 10);
+            if (d == digits / 2 && (seed & 1))
+            {
+                text[len++] = '.';
+            }
+        }
+        sprintf(text + len, "e%d", (int)((seed >> 32) % 700) - 350);
+        random_ok &= same_as_strtod(text);
+    }
+    CHECK(random_ok);
+}
+
+void test_strconv(void)
+{
+    test_integers();
+    test_floats();
+}
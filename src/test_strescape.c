@@ -0,0 +1,130 @@
+#include <stdint.h>
+#include <string.h>
+#include "sch_strescape.h"
+#include "test.h"
+
+typedef void (*escape_fn)(string_t *str);
+typedef int (*unescape_fn)(string_t *str);
+
+static int escapes_to(escape_fn escape, const char *text, const char *want)
+{
+    string_t str;
+    int same;
+    dstrnew(&str, text);
+    escape(&str);
+    same = dstrcmp(&str, want) == 0;
+    dstrfree(&str);
+    return same;
+}
+
+/// A malformed input must be rejected and left as it was.
+static int rejects(unescape_fn unescape, const char *text)
+{
+    string_t str;
+    int ok;
+    dstrnew(&str, text);
+    ok = unescape(&str) == 0 && dstrcmp(&str, text) == 0;
+    dstrfree(&str);
+    return ok;
+}
+
+static int replaces_to(const char *text, const char *from, const char *to, size_t count, const char *want)
+{
+    string_t str;
+    int ok;
+    dstrnew(&str, text);
+    ok = dstrreplace(&str, from, to) == count && dstrcmp(&str, want) == 0;
+    dstrfree(&str);
+    return ok;
+}
+
+/// Replacing with patterns that are suffixes of the string itself, starting at the given offsets.
+static int replaces_own(const char *text, size_t from_at, size_t to_at, size_t count, const char *want)
+{
+    string_t str;
+    int ok;
+    dstrnew(&str, text);
+    ok = dstrreplace(&str, dstrc(&str) + from_at, dstrc(&str) + to_at) == count && dstrcmp(&str, want) == 0;
+    dstrfree(&str);
+    return ok;
+}
+
+/// Escaping then unescaping must give back the original, for strings on both sides of the stack limit
+/// and of the 16-byte SIMD blocks.
+static int round_trips(escape_fn escape, unescape_fn unescape, const char *alphabet)
+{
+    char text[101];
+    uint64_t rng = 12345;
+    size_t len, i, alphabet_len = strlen(alphabet);
+    int ok = 1;
+
+    for (len = 0; len <= 100; len++)
+    {
+        string_t str;
+        for (i = 0; i < len; i++)
+        {
+            rng = rng * 6364136223846793005ull + 1442695040888963407ull;
+            text[i] = alphabet[(rng >> 33) % alphabet_len];
+        }
+        text[len] = '\0';
+
+        dstrnew(&str, text);
+        escape(&str);
+        ok &= unescape(&str) == 1;
+        ok &= dstrlen(&str) == len && dstrcmp(&str, text) == 0;
+        dstrfree(&str);
+    }
+    return ok;
+}
+
+void test_strescape(void)
+{
+    static const char mixed[] = "abcXYZ019 \"\\,/%+-._~\r\n\t\b\f\x01\x1f\x7f\xc3\xa9";
+
+    CHECK(escapes_to(dstrescapejson, "", ""));
+    CHECK(escapes_to(dstrescapejson, "plain text", "plain text"));
+    CHECK(escapes_to(dstrescapejson, "say \"hi\"\\", "say \\\"hi\\\"\\\\"));
+    CHECK(escapes_to(dstrescapejson, "\b\f\n\r\t", "\\b\\f\\n\\r\\t"));
+    CHECK(escapes_to(dstrescapejson, "\x01 and \x1f", "\\u0001 and \\u001F"));
+    CHECK(escapes_to(dstrescapejson, "a long string that lives on the heap, \"quoted\"",
+                     "a long string that lives on the heap, \\\"quoted\\\""));
+
+    CHECK(escapes_to(dstrescapecsv, "plain", "plain"));
+    CHECK(escapes_to(dstrescapecsv, "a,b", "\"a,b\""));
+    CHECK(escapes_to(dstrescapecsv, "say \"hi\"", "\"say \"\"hi\"\"\""));
+    CHECK(escapes_to(dstrescapecsv, "two\nlines", "\"two\nlines\""));
+
+    CHECK(escapes_to(dstrurlencode, "AZaz09-._~", "AZaz09-._~"));
+    CHECK(escapes_to(dstrurlencode, "a b/c?d=e", "a%20b%2Fc%3Fd%3De"));
+    CHECK(escapes_to(dstrurlencode, "\xc3\xa9", "%C3%A9"));
+
+    CHECK(round_trips(dstrescapejson, dstrunescapejson, mixed));
+    CHECK(round_trips(dstrescapecsv, dstrunescapecsv, mixed));
+    CHECK(round_trips(dstrurlencode, dstrurldecode, mixed));
+    CHECK(round_trips(dstrescapejson, dstrunescapejson, "\"\\\n"));
+    CHECK(round_trips(dstrescapecsv, dstrunescapecsv, "\","));
+    CHECK(round_trips(dstrurlencode, dstrurldecode, "% "));
+
+    CHECK(rejects(dstrunescapejson, "trailing \\"));
+    CHECK(rejects(dstrunescapejson, "\\x"));
+    CHECK(rejects(dstrunescapejson, "\\u12"));
+    CHECK(rejects(dstrunescapejson, "\\u12g4"));
+    CHECK(rejects(dstrunescapejson, "\\u0000"));
+    CHECK(rejects(dstrunescapecsv, "\"unterminated"));
+    CHECK(rejects(dstrunescapecsv, "\"a\"b\""));
+    CHECK(rejects(dstrurldecode, "%4"));
+    CHECK(rejects(dstrurldecode, "%zz"));
+    CHECK(rejects(dstrurldecode, "%00"));
+
+    CHECK(replaces_to("aaaa", "a", "bb", 4, "bbbbbbbb"));
+    CHECK(replaces_to("abcabcabc", "abc", "", 3, ""));
+    CHECK(replaces_to("aaa", "aa", "b", 1, "ba"));
+    CHECK(replaces_to("no match here", "xyz", "q", 0, "no match here"));
+    CHECK(replaces_own("abab", 2, 0, 2, "abababab"));
+    CHECK(replaces_own("abcabc", 3, 6, 2, ""));
+    CHECK(replaces_own("stack, then heap: z", 18, 0, 1, "stack, then heap: stack, then heap: z"));
+    CHECK(replaces_own("a heap string that grows when it replaces its x", 46, 0, 1,
+                       "a heap string that grows when it replaces its a heap string that grows when it replaces its x"));
+    CHECK(replaces_to("one needle in a haystack that is longer than sixteen bytes, needle", "needle", "pin", 2,
+                      "one pin in a haystack that is longer than sixteen bytes, pin"));
+}
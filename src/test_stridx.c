@@ -0,0 +1,228 @@
+#include <stdint.h>
+#include <string.h>
+#include "sch_stridx.h"
+#include "test.h"
+
+// Long enough to grow the bucket table past SCH_STRIDX_MIN_BITS twice, so appends also cross rehashes.
+#define DOC_LEN 10000
+#define MIN_LEN 64
+#define MAX_NEEDLE 12
+
+static uint64_t next_rand(uint64_t *rng)
+{
+    *rng = *rng * 6364136223846793005ull + 1442695040888963407ull;
+    return *rng >> 33;
+}
+
+// The brute-force scan the index is checked against.
+
+static size_t ref_find(const string_t *str, const char *needle, size_t len)
+{
+    const char *data = dstrc(str);
+    size_t i;
+    for (i = 0; i + len <= dstrlen(str); i++)
+    {
+        if (memcmp(data + i, needle, len) == 0)
+        {
+            return i;
+        }
+    }
+    return SCH_STRIDX_NONE;
+}
+
+static size_t ref_count(const string_t *str, const char *needle, size_t len)
+{
+    const char *data = dstrc(str);
+    size_t i, count = 0;
+    for (i = 0; i + len <= dstrlen(str); i++)
+    {
+        count += memcmp(data + i, needle, len) == 0;
+    }
+    return count;
+}
+
+static int agrees(stridx_t *idx, const string_t *str, const char *needle, size_t len)
+{
+    return stridxfind(idx, str, needle, len) == ref_find(str, needle, len) &&
+           stridxcount(idx, str, needle, len) == ref_count(str, needle, len);
+}
+
+/// The index covers every gram of the string, or nothing if the string is too short to index.
+static int synced(const stridx_t *idx, const string_t *str)
+{
+    size_t len = dstrlen(str);
+    if (len < idx->min_len || len < SCH_STRIDX_GRAM)
+    {
+        return idx->next.size == 0;
+    }
+    return idx->next.size == len - SCH_STRIDX_GRAM + 1;
+}
+
+/// Query needles of every length up to MAX_NEEDLE: some copied from the string, some starting just before from
+/// so they straddle the last append, and some random ones that mostly don't occur.
+static int agrees_on_needles(stridx_t *idx, const string_t *str, size_t from, const char *alphabet, uint64_t *rng)
+{
+    size_t len = dstrlen(str), alphabet_len = strlen(alphabet), m, i;
+    char needle[MAX_NEEDLE];
+    int ok = 1;
+
+    for (m = 1; m <= MAX_NEEDLE; m++)
+    {
+        if (len >= m)
+        {
+            memcpy(needle, dstrc(str) + next_rand(rng) % (len - m + 1), m);
+            ok &= agrees(idx, str, needle, m);
+
+            i = from > m / 2 ? from - m / 2 : 0;
+            if (i + m <= len)
+            {
+                memcpy(needle, dstrc(str) + i, m);
+                ok &= agrees(idx, str, needle, m);
+            }
+        }
+        for (i = 0; i < m; i++)
+        {
+            needle[i] = alphabet[next_rand(rng) % alphabet_len];
+        }
+        ok &= agrees(idx, str, needle, m);
+    }
+    ok &= agrees(idx, str, "zzzzzz", 6);
+    ok &= synced(idx, str);
+    return ok;
+}
+
+static void append_random(string_t *str, size_t len, const char *alphabet, uint64_t *rng)
+{
+    size_t alphabet_len = strlen(alphabet), i;
+    for (i = 0; i < len; i++)
+    {
+        dstrcatc(str, alphabet[next_rand(rng) % alphabet_len]);
+    }
+}
+
+/// Grow a string in random steps, querying after each one so every query extends the index.
+static void check_appends(const char *alphabet)
+{
+    string_t doc;
+    stridx_t idx;
+    uint64_t rng = 3;
+
+    dstrnew(&doc, "");
+    stridxnew(&idx, MIN_LEN);
+
+    CHECK(agrees_on_needles(&idx, &doc, 0, alphabet, &rng));
+    while (dstrlen(&doc) < DOC_LEN)
+    {
+        size_t from = dstrlen(&doc);
+        append_random(&doc, next_rand(&rng) % 300, alphabet, &rng);
+        CHECK(agrees_on_needles(&idx, &doc, from, alphabet, &rng));
+    }
+
+    // Appending several times between queries must work the same as one append.
+    {
+        size_t from = dstrlen(&doc);
+        append_random(&doc, 5, alphabet, &rng);
+        append_random(&doc, 1, alphabet, &rng);
+        dstrcat(&doc, "zzzz");
+        CHECK(agrees_on_needles(&idx, &doc, from, alphabet, &rng));
+    }
+
+    // stridxsync on its own must leave the index where a query would.
+    append_random(&doc, 100, alphabet, &rng);
+    stridxsync(&idx, &doc);
+    CHECK(synced(&idx, &doc));
+    CHECK(agrees_on_needles(&idx, &doc, dstrlen(&doc) - 100, alphabet, &rng));
+
+    stridxfree(&idx);
+    dstrfree(&doc);
+}
+
+/// Shrinking the string or rewriting its last bytes must rebuild the index, other changes need stridxclr.
+static void check_rebuilds(const char *alphabet)
+{
+    static char text[DOC_LEN * 2 + 1];
+    string_t doc;
+    stridx_t idx;
+    uint64_t rng = 4;
+    size_t len;
+
+    dstrnew(&doc, "");
+    stridxnew(&idx, MIN_LEN);
+    append_random(&doc, DOC_LEN, alphabet, &rng);
+    memcpy(text, dstrc(&doc), DOC_LEN + 1);
+    CHECK(agrees_on_needles(&idx, &doc, 0, alphabet, &rng));
+
+    // Shrink, to lengths that stay indexed and then to ones that fall below MIN_LEN and below a gram.
+    for (len = DOC_LEN / 2; len > 0; len /= 3)
+    {
+        text[len] = '\0';
+        dstrcpy(&doc, text);
+        CHECK(agrees_on_needles(&idx, &doc, len, alphabet, &rng));
+    }
+
+    // Shrink, then append different bytes back up past the old length.
+    dstrcpy(&doc, "");
+    append_random(&doc, DOC_LEN, alphabet, &rng);
+    CHECK(agrees_on_needles(&idx, &doc, 0, alphabet, &rng));
+    memcpy(text, dstrc(&doc), DOC_LEN + 1);
+    text[DOC_LEN / 4] = '\0';
+    dstrcpy(&doc, text);
+    append_random(&doc, DOC_LEN, alphabet, &rng);
+    CHECK(agrees_on_needles(&idx, &doc, DOC_LEN / 4, alphabet, &rng));
+
+    // Same length, different last byte.
+    memcpy(text, dstrc(&doc), dstrlen(&doc) + 1);
+    len = dstrlen(&doc);
+    text[len - 1] = text[len - 1] == 'z' ? 'y' : 'z';
+    dstrcpy(&doc, text);
+    CHECK(agrees_on_needles(&idx, &doc, len - 1, alphabet, &rng));
+    memcpy(text + len - 6, "zyzyzy", 6);
+    dstrcpy(&doc, text);
+    CHECK(agrees(&idx, &doc, "zyzyzy", 6));
+    CHECK(stridxcount(&idx, &doc, "zyzy", 4) == ref_count(&doc, "zyzy", 4));
+
+    // A change in the middle isn't noticed until stridxclr.
+    memcpy(text + len / 2, "yzyzyz", 6);
+    dstrcpy(&doc, text);
+    stridxclr(&idx);
+    CHECK(synced(&idx, &doc) == 0);
+    CHECK(agrees(&idx, &doc, "yzyzyz", 6));
+    CHECK(agrees_on_needles(&idx, &doc, len / 2, alphabet, &rng));
+
+    stridxfree(&idx);
+    dstrfree(&doc);
+}
+
+/// Strings below the threshold are scanned and never indexed.
+static void check_threshold(void)
+{
+    string_t doc;
+    stridx_t idx;
+    uint64_t rng = 5;
+
+    dstrnew(&doc, "");
+    stridxnew(&idx, SCH_STRIDX_MIN_LEN);
+    while (dstrlen(&doc) + 200 < SCH_STRIDX_MIN_LEN)
+    {
+        append_random(&doc, 200, "ab", &rng);
+        CHECK(agrees_on_needles(&idx, &doc, dstrlen(&doc) - 200, "ab", &rng));
+        CHECK(idx.next.size == 0 && idx.buckets.size == 0);
+    }
+    append_random(&doc, 200, "ab", &rng);
+    CHECK(agrees_on_needles(&idx, &doc, dstrlen(&doc) - 200, "ab", &rng));
+    CHECK(idx.next.size > 0);
+
+    stridxfree(&idx);
+    dstrfree(&doc);
+}
+
+void test_stridx(void)
+{
+    // Small alphabets give long bucket chains and many overlapping matches.
+    check_appends("ab");
+    check_appends("abcd");
+    check_appends("abcdefghijklmnopqrstuvwxyz .,");
+    check_rebuilds("ab");
+    check_rebuilds("abcdefgh");
+    check_threshold();
+}
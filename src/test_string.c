@@ -0,0 +1,40 @@
+#include <stdint.h>
+#include <string.h>
+#include "sch_string.h"
+#include "test.h"
+
+// Known answers for dstrhash, one or more per branch of wyhash: empty, 1 to 3 bytes, 4 to 16, 17 to 48 and past 48.
+// The first is the reference vector for "" with seed 0, the rest come from the reference code with seed 0.
+static const struct
+{
+    const char *text;
+    uint64_t hash;
+} known_hashes[] = {
+    {"", 0x0409638ee2bde459ull},
+    {"a", 0x28d2053309d28531ull},
+    {"abc", 0x02a4f1d7cb516c72ull},
+    {"abcd", 0x48dfe2b09ab52113ull},
+    {"message digest", 0x41d032e1df79b67eull},
+    {"0123456789abcdef", 0xc304e72c387cd229ull},
+    {"0123456789abcdefg", 0xb496f8f306600195ull},
+    {"abcdefghijklmnopqrstuvwxyz", 0x774fa8c21ed6acd2ull},
+    {"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789", 0x0369bcbe3f0f0c0dull},
+    {"12345678901234567890123456789012345678901234567890123456789012345678901234567890", 0x48662e17cabfab37ull},
+};
+
+void test_string(void)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(known_hashes) / sizeof(known_hashes[0]); i++)
+    {
+        string_t str;
+        dstrnew(&str, known_hashes[i].text);
+        CHECK(dstrhashn(known_hashes[i].text, strlen(known_hashes[i].text)) == known_hashes[i].hash);
+        CHECK(dstrhash(&str) == known_hashes[i].hash);
+        CHECK(dstrhashcached(&str) == known_hashes[i].hash);
+        CHECK(dstrhashcached(&str) == known_hashes[i].hash);
+        dstrfree(&str);
+    }
+    CHECK(dstrhashn(NULL, 0) == known_hashes[0].hash);
+}
@@ -0,0 +1,173 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sch_strtab.h"
+#include "test.h"
+
+#define RANDOM_STRINGS 500
+
+/// The table holds exactly want[0..n), checked through both strtabget and strtablen.
+static int holds(const strtab_t *tab, const char *const *want, size_t n)
+{
+    size_t i;
+    int ok = strtabsiz(tab) == n;
+
+    for (i = 0; ok && i < n; i++)
+    {
+        size_t len = (size_t)-1;
+        const char *s = strtabget(tab, i, &len);
+        ok &= len == strlen(want[i]) && strtablen(tab, i) == len && strcmp(s, want[i]) == 0;
+    }
+    return ok;
+}
+
+static const char *const *ref_strings;
+
+/// The reference order: strcmp, with ties broken by index since strtabsort is stable.
+static int ref_compare(const void *a, const void *b)
+{
+    size_t ia = *(const size_t *)a, ib = *(const size_t *)b;
+    int c = strcmp(ref_strings[ia], ref_strings[ib]);
+    if (c != 0)
+    {
+        return c;
+    }
+    return ia < ib ? -1 : ia > ib;
+}
+
+static int sorts_like_strcmp(const char *const *strings, size_t n)
+{
+    strtab_t tab;
+    size_t *perm = malloc((n + 1) * sizeof(size_t));
+    size_t *want = malloc((n + 1) * sizeof(size_t));
+    size_t i;
+    int ok;
+
+    strtabnew(&tab, 1);
+    strtabcat(&tab, strings, n);
+    for (i = 0; i < n; i++)
+    {
+        want[i] = i;
+    }
+    ref_strings = strings;
+    qsort(want, n, sizeof(size_t), ref_compare);
+
+    ok = strtabsort(&tab, perm) == 1 && memcmp(perm, want, n * sizeof(size_t)) == 0;
+
+    strtabfree(&tab);
+    free(want);
+    free(perm);
+    return ok;
+}
+
+/// Copying into a string that already holds something must replace it, for stack and heap strings.
+static int copies_into(const char *initial)
+{
+    static const char *const entries[] = {"banana", "apple", "", "a string long enough to live on the heap", "kiwi"};
+    const size_t n = sizeof(entries) / sizeof(entries[0]);
+    strtab_t tab;
+    string_t str;
+    size_t i;
+    int ok = 1;
+
+    strtabnew(&tab, 4);
+    strtabcat(&tab, entries, n);
+    dstrnew(&str, initial);
+    for (i = 0; i < n; i++)
+    {
+        strtabdstr(&tab, i, &str);
+        ok &= dstrlen(&str) == strlen(entries[i]) && dstrcmp(&str, entries[i]) == 0;
+    }
+    dstrfree(&str);
+    strtabfree(&tab);
+    return ok;
+}
+
+static void check_appends(void)
+{
+    static const char *const want[] = {"apple", "", "ban", "cherry", "dates", "", "elderberry"};
+    static const char *const batch[] = {"cherry", "dates", "", "elderberry"};
+    strtab_t tab;
+
+    // A capacity of 1 makes every append grow both buffers.
+    strtabnew(&tab, 1);
+    CHECK(strtabsiz(&tab) == 0 && strtabbytes(&tab) == 0);
+
+    strtabpush(&tab, "apple");
+    strtabpushn(&tab, NULL, 0);
+    strtabpushn(&tab, "banana", 3);
+    CHECK(holds(&tab, want, 3));
+
+    strtabcat(&tab, batch, 4);
+    strtabcat(&tab, batch, 0);
+    CHECK(holds(&tab, want, 7));
+    CHECK(strtabbytes(&tab) == 5 + 0 + 3 + 6 + 5 + 0 + 10 + 7);
+
+    strtabclr(&tab);
+    CHECK(strtabsiz(&tab) == 0 && strtabbytes(&tab) == 0);
+    strtabpush(&tab, "apple");
+    CHECK(holds(&tab, want, 1));
+
+    strtabfree(&tab);
+}
+
+static void check_pushd(void)
+{
+    static const char *const want[] = {"short", "a string long enough to live on the heap"};
+    strtab_t tab;
+    string_t str;
+
+    strtabnew(&tab, 2);
+    dstrnew(&str, want[0]);
+    strtabpushd(&tab, &str);
+    dstrcpy(&str, want[1]);
+    strtabpushd(&tab, &str);
+    CHECK(holds(&tab, want, 2));
+
+    dstrfree(&str);
+    strtabfree(&tab);
+}
+
+static void check_sort(void)
+{
+    // Empty strings, strings equal in their first 8 bytes, prefixes of each other at and around 8 bytes, and equal keys.
+    static const char *const tricky[] = {
+        "prefix01b", "", "prefix01", "prefix01a", "prefix0", "b", "prefix01", "", "prefix01aa",
+        "prefix02", "a", "prefix01b", "\xff", "prefix01\x01", "b", "prefix0\x7f",
+    };
+    static char storage[RANDOM_STRINGS][14];
+    const char *random[RANDOM_STRINGS];
+    uint64_t rng = 9;
+    size_t i, j;
+
+    CHECK(sorts_like_strcmp(tricky, 0));
+    CHECK(sorts_like_strcmp(tricky, 1));
+    CHECK(sorts_like_strcmp(tricky, sizeof(tricky) / sizeof(tricky[0])));
+
+    // Lengths up to 13 over a small alphabet, so many strings share their first 8 bytes or are equal.
+    for (i = 0; i < RANDOM_STRINGS; i++)
+    {
+        size_t len;
+        rng = rng * 6364136223846793005ull + 1442695040888963407ull;
+        len = (size_t)(rng >> 60) % 14;
+        for (j = 0; j < len; j++)
+        {
+            rng = rng * 6364136223846793005ull + 1442695040888963407ull;
+            storage[i][j] = j < 6 ? 'x' : "ab\xc3"[(rng >> 33) % 3];
+        }
+        storage[i][len] = '\0';
+        random[i] = storage[i];
+    }
+    CHECK(sorts_like_strcmp(random, RANDOM_STRINGS));
+}
+
+void test_strtab(void)
+{
+    check_appends();
+    check_pushd();
+    check_sort();
+
+    CHECK(copies_into(NULL));
+    CHECK(copies_into("abcdefgh"));
+    CHECK(copies_into("a heap string, longer than the stack buffer of a string_t"));
+}
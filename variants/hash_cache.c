@@ -0,0 +1,179 @@
+// The checks of sch_string.h's hashing that need its implementation in this file:
+// the wyhash reference vectors, which use seeds dstrhash doesn't expose,
+// and the hash cache, which only exists when SCH_STRING_CACHE_HASH is defined.
+
+#define SCH_STRING_CACHE_HASH
+#define SCH_IMPL
+#include <stdint.h>
+#include <string.h>
+#include "sch_string.h"
+#include "sch_strescape.h"
+#include "sch_strcodec.h"
+#include "test.h"
+
+int sch_test_failures = 0;
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    unsigned char *data;
+} byte_array;
+
+/// The reference test vectors of wyhash final version 4: message i hashed with seed i.
+static void check_reference_vectors(void)
+{
+    static const struct
+    {
+        const char *text;
+        uint64_t hash;
+    } vectors[] = {
+        {"", 0x0409638ee2bde459ull},
+        {"a", 0xa8412d091b5fe0a9ull},
+        {"abc", 0x32dd92e4b2915153ull},
+        {"message digest", 0x8619124089a3a16bull},
+        {"abcdefghijklmnopqrstuvwxyz", 0x7a43afb61d7f5f40ull},
+        {"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789", 0xff42329b90e50d58ull},
+        {"12345678901234567890123456789012345678901234567890123456789012345678901234567890", 0xc39cab13b115aad3ull},
+    };
+    size_t i;
+
+    for (i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++)
+    {
+        CHECK(sch_wyhash(vectors[i].text, strlen(vectors[i].text), i) == vectors[i].hash);
+    }
+}
+
+static const char heap_text[] = "a \"heap\" string, long enough not to fit on the stack, with 0123456789abcdef";
+
+/// Hash a heap string through the cache, and check that the cache now holds that hash.
+static int cache(string_t *str)
+{
+    uint64_t hash = dstrhashcached(str);
+    return (str->type & SCH_DSTR_HASH_BIT) && hash == dstrhash(str) && dstrhashcached(str) == hash;
+}
+
+typedef void (*mutation)(string_t *str);
+
+static void cat(string_t *str) { dstrcat(str, "!"); }
+static void catn(string_t *str) { dstrcatn(str, "xyz", 2); }
+static void catc(string_t *str) { dstrcatc(str, '?'); }
+static void catd(string_t *str)
+{
+    string_t other;
+    dstrnew(&other, "tail");
+    dstrcatd(str, &other);
+    dstrfree(&other);
+}
+static void cpy(string_t *str) { dstrcpy(str, "another string that is also long enough for the heap"); }
+static void cpyd(string_t *str)
+{
+    string_t other;
+    dstrnew(&other, "yet another string that is long enough for the heap");
+    dstrcpyd(str, &other);
+    dstrfree(&other);
+}
+static void clr(string_t *str) { dstrclr(str); }
+static void fit(string_t *str)
+{
+    // Leave spare capacity, so dstrfit moves the cache slot without changing the contents.
+    dstrcatc(str, '.');
+    dstrhashcached(str);
+    dstrfit(str);
+}
+static void replace(string_t *str) { dstrreplace(str, "heap", "HEAP"); }
+static void escape_json(string_t *str) { dstrescapejson(str); }
+static void unescape_json(string_t *str)
+{
+    dstrescapejson(str);
+    dstrhashcached(str);
+    dstrunescapejson(str);
+}
+static void escape_csv(string_t *str) { dstrescapecsv(str); }
+static void unescape_csv(string_t *str)
+{
+    dstrescapecsv(str);
+    dstrhashcached(str);
+    dstrunescapecsv(str);
+}
+static void url_encode(string_t *str) { dstrurlencode(str); }
+static void url_decode(string_t *str)
+{
+    dstrurlencode(str);
+    dstrhashcached(str);
+    dstrurldecode(str);
+}
+static void cat_hex(string_t *str) { dstrcathex(str, "\x01\xff", 2); }
+static void cat_base64(string_t *str) { dstrcatbase64(str, "abc", 3); }
+
+/// Each writer must drop the cached hash, so the next dstrhashcached hashes the new contents.
+static void check_cache(void)
+{
+    static const struct
+    {
+        const char *name;
+        mutation mutate;
+    } mutations[] = {
+        {"dstrcat", cat},
+        {"dstrcatn", catn},
+        {"dstrcatc", catc},
+        {"dstrcatd", catd},
+        {"dstrcpy", cpy},
+        {"dstrcpyd", cpyd},
+        {"dstrclr", clr},
+        {"dstrfit", fit},
+        {"dstrreplace", replace},
+        {"dstrescapejson", escape_json},
+        {"dstrunescapejson", unescape_json},
+        {"dstrescapecsv", escape_csv},
+        {"dstrunescapecsv", unescape_csv},
+        {"dstrurlencode", url_encode},
+        {"dstrurldecode", url_decode},
+        {"dstrcathex", cat_hex},
+        {"dstrcatbase64", cat_base64},
+    };
+    size_t i;
+
+    for (i = 0; i < sizeof(mutations) / sizeof(mutations[0]); i++)
+    {
+        string_t str;
+
+        dstrnew(&str, heap_text);
+        CHECK(cache(&str));
+        mutations[i].mutate(&str);
+        if ((str.type & SCH_DSTR_HASH_BIT) || dstrhashcached(&str) != dstrhashn(dstrc(&str), dstrlen(&str)))
+        {
+            sch_test_failures++;
+            fprintf(stderr, "%s left a stale cached hash\n", mutations[i].name);
+        }
+        dstrfree(&str);
+    }
+
+    // The decoders only read the string, so they keep its cache.
+    {
+        string_t str;
+        byte_array bytes;
+
+        darnew(&bytes, 1);
+        dstrnew(&str, "00112233445566778899aabbccddeeff00112233445566778899aabbccddeeff");
+        CHECK(cache(&str));
+        CHECK(dstrdechex(&str, sch_to_dar(&bytes)) == 1);
+        CHECK(str.type & SCH_DSTR_HASH_BIT);
+        dstrfree(&str);
+        darfree(&bytes);
+    }
+}
+
+int main(void)
+{
+    check_reference_vectors();
+    check_cache();
+
+    if (sch_test_failures > 0)
+    {
+        printf("%d checks failed\n", sch_test_failures);
+        return 1;
+    }
+    printf("All hash cache checks passed\n");
+    return 0;
+}
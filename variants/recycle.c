@@ -0,0 +1,107 @@
+// The checks of sch_array.h and sch_string.h built with SCH_RECYCLE: once warmed up,
+// creating, growing, shrinking and freeing strings and arrays must be served from the recycler without malloc.
+
+#define SCH_RECYCLE
+#define SCH_IMPL
+#include <string.h>
+#include "sch_recycle.h"
+#include "sch_array.h"
+#include "sch_string.h"
+#include "test.h"
+
+int sch_test_failures = 0;
+
+typedef struct
+{
+    size_t size;
+    size_t capacity;
+    int *data;
+} int_array;
+
+#define LIVE 16
+#define WARMUP_ROUNDS 4
+#define ROUNDS 200
+
+static const char long_text[] = "a string long enough that it never fits in the stack buffer of a string_t";
+
+/// Builds LIVE strings and arrays of several sizes, through every allocating path, then frees them all.
+/// Returns 0 if any contents came out wrong.
+static int churn_once(void)
+{
+    string_t strs[LIVE];
+    int_array arrs[LIVE];
+    size_t i, j;
+    int ok = 1;
+
+    for (i = 0; i < LIVE; i++)
+    {
+        // Stack strings moved to the heap by appending, heap strings grown by appending and shrunk by dstrfit.
+        dstrnew(&strs[i], i % 2 == 0 ? "short" : long_text);
+        for (j = 0; j < i * 8; j++)
+        {
+            dstrcatc(&strs[i], (char)('a' + j % 26));
+        }
+        dstrcpy(&strs[i], long_text);
+        dstrfit(&strs[i]);
+        ok &= dstrcmp(&strs[i], long_text) == 0;
+
+        // Arrays grown one push at a time from a small capacity, then trimmed.
+        darnew(&arrs[i], 1);
+        for (j = 0; j < 64 + i * 100; j++)
+        {
+            int value = (int)j;
+            darpush(&arrs[i], value);
+        }
+        while (darsiz(&arrs[i]) > 32 + i * 50)
+        {
+            darpop(&arrs[i]);
+        }
+        darfit(&arrs[i]);
+        ok &= darsiz(&arrs[i]) == 32 + i * 50 && arrs[i].data[darsiz(&arrs[i]) - 1] == (int)darsiz(&arrs[i]) - 1;
+    }
+    for (i = 0; i < LIVE; i++)
+    {
+        dstrfree(&strs[i]);
+        darfree(&arrs[i]);
+    }
+    return ok;
+}
+
+int main(void)
+{
+    struct sch_recycle_stats warm, after;
+    int i, ok = 1;
+
+    for (i = 0; i < WARMUP_ROUNDS; i++)
+    {
+        ok &= churn_once();
+    }
+    sch_recycle_stats(&warm);
+    CHECK(warm.misses > 0 && warm.cached_blocks > 0);
+
+    for (i = 0; i < ROUNDS; i++)
+    {
+        ok &= churn_once();
+    }
+    sch_recycle_stats(&after);
+    CHECK(ok);
+    CHECK(after.misses == warm.misses);
+    CHECK(after.hits > warm.hits);
+    CHECK(after.cached_blocks == warm.cached_blocks && after.cached_bytes == warm.cached_bytes);
+    if (after.misses != warm.misses)
+    {
+        fprintf(stderr, "misses grew from %zu to %zu after warm-up\n", warm.misses, after.misses);
+    }
+
+    sch_recycle_trim();
+    sch_recycle_stats(&after);
+    CHECK(after.cached_blocks == 0 && after.cached_bytes == 0);
+
+    if (sch_test_failures > 0)
+    {
+        printf("%d checks failed\n", sch_test_failures);
+        return 1;
+    }
+    printf("All recycle checks passed\n");
+    return 0;
+}